@@ -0,0 +1,46 @@
+/*
+	===== LINCE-BENCH =====
+
+	Synthetic scenes drawn through the renderer in headless mode,
+	with fixed sizes and random seeds so that runs can be compared.
+	Results are written as JSON, by default to lince-bench.json.
+
+	Options:
+		--frames N     measured frames per scene (default 300)
+		--warmup N     frames drawn before measuring (default 30)
+		--quads N      quads in the quad and sprite scenes (default 20000)
+		--textures K   textures in the textured and pooled scenes (default 64)
+		--map WxH      size of the tilemap in tiles (default 256x144)
+		--size WxH     size of the framebuffer in pixels (default 1280x720)
+		--scene NAME   only runs the named scene
+		--out PATH     file to write the results to, or - for stdout
+		--trace PATH   records a profiler trace of the run
+*/
+
+#ifndef LINCE_BENCH_H
+#define LINCE_BENCH_H
+
+#include "lince.h"
+#include "lince/core/profiler.h"
+
+/* Sizes of the benchmark scenes */
+typedef struct BenchSettings {
+	uint32_t frames, warmup;
+	uint32_t quads;
+	uint32_t textures;
+	uint32_t map_width, map_height;
+	uint32_t width, height;
+} BenchSettings;
+
+/* Scene drawn every frame while it is measured */
+typedef struct BenchScene {
+	const char* name;
+	void (*init)(const BenchSettings* settings);
+	void (*draw)(uint32_t frame); // frame number since the scene started
+	void (*terminate)(void);
+} BenchScene;
+
+/* Returns the list of scenes and sets their number */
+const BenchScene* GetBenchScenes(uint32_t* count);
+
+#endif /* LINCE_BENCH_H */
@@ -0,0 +1,233 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glad/glad.h>
+
+#include "bench.h"
+
+#define BENCH_MAX_SCENES 16
+
+/* Measurements of one scene */
+typedef struct BenchResult {
+	const char* name;
+	uint32_t frames;
+	double seconds;      // wall time of the measured frames, including the GPU
+	double cpu_ms;       // time spent submitting the scene, added up over frames
+	double gpu_ms;       // GPU frame times, added up over frames
+	size_t quads, culled, batches, draw_calls, texture_binds, bytes_uploaded;
+} BenchResult;
+
+/* Benchmark state, advanced one frame at a time by the app */
+static struct {
+	BenchSettings settings;
+	const char* only_scene; // name of the single scene to run, or NULL
+	const char* out_path;
+	const char* trace_path; // profiler trace to record, or NULL
+	const char* shader_cache_dir; // directory of cached shader binaries, or NULL
+	const BenchScene* scenes;
+	uint32_t scene_count;
+	uint32_t scene;       // index of the running scene
+	uint32_t frame;       // frames since the running scene started
+	uint64_t start;       // ticks at the first measured frame
+	BenchResult results[BENCH_MAX_SCENES];
+	uint32_t result_count;
+} run = {0};
+
+
+/* Parses a "WxH" pair, returns false if it is not valid */
+static LinceBool ParseSize(const char* str, uint32_t* w, uint32_t* h){
+	unsigned int a = 0, b = 0;
+	if(sscanf(str, "%ux%u", &a, &b) != 2 || a == 0 || b == 0) return LinceFalse;
+	*w = a;
+	*h = b;
+	return LinceTrue;
+}
+
+/* Reads the command line options into the settings, returns false on an invalid option */
+static LinceBool ParseArgs(int argc, const char* argv[]){
+	for(int i = 1; i < argc; ++i){
+		const char* opt = argv[i];
+		const char* val = (i + 1 < argc) ? argv[i + 1] : NULL;
+		if(!val) return LinceFalse;
+		++i;
+		if     (strcmp(opt, "--frames") == 0)   run.settings.frames = (uint32_t)atoi(val);
+		else if(strcmp(opt, "--warmup") == 0)   run.settings.warmup = (uint32_t)atoi(val);
+		else if(strcmp(opt, "--quads") == 0)    run.settings.quads = (uint32_t)atoi(val);
+		else if(strcmp(opt, "--textures") == 0) run.settings.textures = (uint32_t)atoi(val);
+		else if(strcmp(opt, "--scene") == 0)    run.only_scene = val;
+		else if(strcmp(opt, "--out") == 0)      run.out_path = val;
+		else if(strcmp(opt, "--trace") == 0)    run.trace_path = val;
+		else if(strcmp(opt, "--shader-cache") == 0) run.shader_cache_dir = val;
+		else if(strcmp(opt, "--map") == 0){
+			if(!ParseSize(val, &run.settings.map_width, &run.settings.map_height)) return LinceFalse;
+		}
+		else if(strcmp(opt, "--size") == 0){
+			if(!ParseSize(val, &run.settings.width, &run.settings.height)) return LinceFalse;
+		}
+		else return LinceFalse;
+	}
+	return run.settings.frames > 0 && run.settings.textures > 0;
+}
+
+/* Writes a string in quotes, escaping the characters JSON does not allow */
+static void WriteJSONString(FILE* file, const char* str){
+	fputc('"', file);
+	for(const char* c = str; c && *c; ++c){
+		if(*c == '"' || *c == '\\') fputc('\\', file);
+		if((unsigned char)*c >= 0x20) fputc(*c, file);
+	}
+	fputc('"', file);
+}
+
+/* Writes the settings and the results of every scene */
+static void WriteResults(FILE* file){
+	const BenchSettings* s = &run.settings;
+	fprintf(file, "{\n  \"renderer\": ");
+	WriteJSONString(file, (const char*)glGetString(GL_RENDERER));
+	fprintf(file, ",\n  \"gl_version\": ");
+	WriteJSONString(file, (const char*)glGetString(GL_VERSION));
+	fprintf(file, ",\n  \"settings\": {\"width\": %u, \"height\": %u, \"frames\": %u, \"warmup\": %u, "
+		"\"quads\": %u, \"textures\": %u, \"map_width\": %u, \"map_height\": %u},\n",
+		s->width, s->height, s->frames, s->warmup, s->quads, s->textures, s->map_width, s->map_height);
+	fprintf(file, "  \"scenes\": [");
+	for(uint32_t i = 0; i != run.result_count; ++i){
+		const BenchResult* r = &run.results[i];
+		double n = (double)r->frames;
+		fprintf(file, "%s\n    {\"name\": ", i == 0 ? "" : ",");
+		WriteJSONString(file, r->name);
+		fprintf(file,
+			", \"frames\": %u, \"fps\": %.2f, \"quads_per_sec\": %.0f, "
+			"\"cpu_ms_per_frame\": %.4f, \"gpu_ms_per_frame\": %.4f, "
+			"\"quads_per_frame\": %.1f, \"culled_per_frame\": %.1f, \"batches_per_frame\": %.2f, "
+			"\"draw_calls_per_frame\": %.2f, \"texture_binds_per_frame\": %.2f, \"bytes_uploaded_per_frame\": %.0f}",
+			r->frames, n / r->seconds, (double)r->quads / r->seconds,
+			r->cpu_ms / n, r->gpu_ms / n,
+			(double)r->quads / n, (double)r->culled / n, (double)r->batches / n,
+			(double)r->draw_calls / n, (double)r->texture_binds / n, (double)r->bytes_uploaded / n
+		);
+	}
+	fprintf(file, "\n  ]\n}\n");
+}
+
+/* Writes the results to the output path, or to stdout if it is "-" */
+static void SaveResults(){
+	FILE* file = strcmp(run.out_path, "-") == 0 ? stdout : fopen(run.out_path, "w");
+	if(!file){
+		fprintf(stderr, "Unable to open '%s'\n", run.out_path);
+		return;
+	}
+	WriteResults(file);
+	if(file != stdout){
+		fclose(file);
+		printf("Results written to %s\n", run.out_path);
+	}
+}
+
+/*
+Moves on to the next scene that should run.
+After the last one, saves the results while the OpenGL context is alive and stops the app.
+*/
+static void StartNextScene(LinceBool first){
+	if(!first) ++run.scene;
+	while(run.scene < run.scene_count && run.only_scene &&
+		strcmp(run.scenes[run.scene].name, run.only_scene) != 0){
+		++run.scene;
+	}
+	run.frame = 0;
+	if(run.scene >= run.scene_count || run.result_count == BENCH_MAX_SCENES){
+		run.scene = run.scene_count;
+		SaveResults();
+		LinceGetAppState()->running = LinceFalse;
+		return;
+	}
+	run.scenes[run.scene].init(&run.settings);
+	run.results[run.result_count] = (BenchResult){
+		.name = run.scenes[run.scene].name,
+		.frames = run.settings.frames
+	};
+}
+
+/* Adds the renderer statistics of the last frame to the result of the running scene */
+static void AddFrameStats(BenchResult* r){
+	LinceRendererStats stats = LinceGetRendererStats();
+	r->quads += stats.quads_drawn;
+	r->culled += stats.quads_culled;
+	r->batches += stats.batches;
+	r->draw_calls += stats.draw_calls;
+	r->texture_binds += stats.texture_binds;
+	r->bytes_uploaded += stats.bytes_uploaded;
+	r->gpu_ms += stats.gpu_ms;
+}
+
+/*
+Draws one frame of the running scene.
+Statistics of a frame are ready on the next one, so each scene
+draws `warmup + frames` frames and reads the last ones one frame later.
+*/
+void OnUpdate(float dt){
+	LINCE_UNUSED(dt);
+	if(run.scene >= run.scene_count) return;
+	const BenchScene* scene = &run.scenes[run.scene];
+	BenchResult* result = &run.results[run.result_count];
+	uint32_t warmup = run.settings.warmup, frames = run.settings.frames;
+
+	if(run.frame > warmup) AddFrameStats(result);
+	if(run.frame == warmup + frames){
+		glFinish(); // waits for the GPU to finish the measured frames
+		result->seconds = (double)(LinceGetProfilerTicks() - run.start) / 1.0e9;
+		scene->terminate();
+		printf("%-10s %8.1f fps %8.3f ms cpu %8.1f batches\n", result->name,
+			(double)frames / result->seconds, result->cpu_ms / (double)frames,
+			(double)result->batches / (double)frames);
+		run.result_count++;
+		StartNextScene(LinceFalse);
+		return;
+	}
+
+	if(run.frame == warmup){
+		glFinish(); // warm-up frames are not measured
+		run.start = LinceGetProfilerTicks();
+	}
+	uint64_t t = LinceGetProfilerTicks();
+	scene->draw(run.frame);
+	if(run.frame >= warmup){
+		result->cpu_ms += (double)(LinceGetProfilerTicks() - t) / 1.0e6;
+	}
+	run.frame++;
+}
+
+void OnInit(){
+	run.scenes = GetBenchScenes(&run.scene_count);
+	StartNextScene(LinceTrue);
+}
+
+
+int main(int argc, const char* argv[]) {
+
+	run.settings = (BenchSettings){
+		.frames = 300, .warmup = 30,
+		.quads = 20000, .textures = 64,
+		.map_width = 256, .map_height = 144,
+		.width = 1280, .height = 720,
+	};
+	run.out_path = "lince-bench.json";
+	if(!ParseArgs(argc, argv)){
+		fprintf(stderr, "Usage: %s [--frames N] [--warmup N] [--quads N] [--textures K] "
+			"[--map WxH] [--size WxH] [--scene NAME] [--out PATH] [--trace PATH] [--shader-cache DIR]\n", argv[0]);
+		return 1;
+	}
+
+	LinceApp* app = LinceGetAppState();
+	app->screen_width = run.settings.width;
+	app->screen_height = run.settings.height;
+	app->title = "lince-bench";
+	app->headless = LinceTrue;
+	app->game_init = OnInit;
+	app->game_on_update = OnUpdate;
+	app->enable_profiling = run.trace_path != NULL;
+	app->profiler_filename = (char*)run.trace_path;
+	app->shader_cache_dir = run.shader_cache_dir;
+	LinceRun();
+
+	return 0;
+}
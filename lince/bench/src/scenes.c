@@ -0,0 +1,368 @@
+#include "bench.h"
+
+#define TEXTURE_SIZE 16    // width and height in pixels of generated textures
+#define SPRITE_TEXTURES 4  // textures shared by the sprites
+#define TILESET_CELLS 8    // cells along each side of the tileset
+#define TILE_PIXELS 8      // width and height in pixels of a tileset cell
+#define HUD_PANELS 8       // translucent panels drawn over the world
+#define HUD_COLUMNS 96     // glyphs in a row of HUD text
+#define HUD_ROWS 32        // rows of HUD text
+
+/* State shared by the scenes, only one of which runs at a time */
+typedef struct BenchState {
+	BenchSettings settings;
+	uint32_t seed;
+	LinceCamera* cam;     // world camera
+	LinceCamera* hud_cam; // screen camera of the mixed scene
+	LinceQuadProps* quads;
+	uint32_t quad_count;
+	LinceTexture** textures;
+	uint32_t texture_count;
+	LinceTexturePool* pool;
+	LinceTile* tiles;
+	LinceTilemap* tilemap;
+	LinceQuadBuffer** buffers; // one per thread of the job system
+	uint32_t buffer_count;
+} BenchState;
+
+static BenchState bench = {0};
+
+
+/* --- Helpers --- */
+
+/* Returns the next pseudo-random number, the same sequence on every run */
+static uint32_t BenchRand(){
+	bench.seed = bench.seed * 1664525u + 1013904223u;
+	return bench.seed >> 8;
+}
+
+/* Returns a pseudo-random number in [a,b] */
+static float BenchRandRange(float a, float b){
+	return a + (b - a) * (float)(BenchRand() & 0xFFFF) / 65535.0f;
+}
+
+/* Creates a camera that sees the world rectangle [-aspect*scale, aspect*scale] x [-scale, scale] around pos */
+static LinceCamera* BenchCreateCamera(float scale, float x, float y){
+	float aspect = (float)bench.settings.width / (float)bench.settings.height;
+	LinceCamera* cam = LinceCreateCamera(aspect);
+	cam->scale = scale;
+	// the camera position is in units of its scale
+	cam->pos[0] = x / scale;
+	cam->pos[1] = y / scale;
+	LinceUpdateCamera(cam);
+	return cam;
+}
+
+/*
+Creates a texture with a random color.
+If `round` is set, the pixels outside a circle are transparent, as in a sprite.
+*/
+static LinceTexture* BenchCreateTexture(uint32_t index, LinceBool round){
+	unsigned char data[TEXTURE_SIZE * TEXTURE_SIZE * 4];
+	unsigned char rgb[3] = {BenchRand() & 0xFF, BenchRand() & 0xFF, BenchRand() & 0xFF};
+	const float r = TEXTURE_SIZE / 2.0f;
+	for(uint32_t y = 0; y != TEXTURE_SIZE; ++y){
+		for(uint32_t x = 0; x != TEXTURE_SIZE; ++x){
+			unsigned char* px = data + (y * TEXTURE_SIZE + x) * 4;
+			float dx = (float)x + 0.5f - r, dy = (float)y + 0.5f - r;
+			LinceBool inside = !round || dx*dx + dy*dy <= r*r;
+			// shade each texel a little so that the texture is not uniform
+			unsigned char shade = (unsigned char)((x ^ y) * 4);
+			px[0] = rgb[0] > shade ? rgb[0] - shade : 0;
+			px[1] = rgb[1];
+			px[2] = rgb[2];
+			px[3] = inside ? 255 : 0;
+		}
+	}
+	char name[LINCE_NAME_MAX];
+	snprintf(name, sizeof(name), "bench_%u", (unsigned)index);
+	LinceTexture* texture = LinceCreateEmptyTexture(name, TEXTURE_SIZE, TEXTURE_SIZE);
+	LinceSetTextureData(texture, data);
+	return texture;
+}
+
+/* Creates the textures used by a scene */
+static void BenchCreateTextures(uint32_t count, LinceBool round){
+	bench.texture_count = count;
+	bench.textures = LinceCalloc(sizeof(LinceTexture*) * count);
+	for(uint32_t i = 0; i != count; ++i){
+		bench.textures[i] = BenchCreateTexture(i, round);
+	}
+}
+
+/* Sets a color to opaque white, which leaves textures untinted */
+static void BenchSetWhite(float color[4]){
+	// quad colors are not aligned for the SIMD stores of cglm
+	color[0] = color[1] = color[2] = color[3] = 1.0f;
+}
+
+/* Creates quads of random size, position, depth and color spread over the view of the world camera */
+static void BenchCreateQuads(uint32_t count){
+	float aspect = (float)bench.settings.width / (float)bench.settings.height;
+	float xmax = aspect * bench.cam->scale, ymax = bench.cam->scale;
+	bench.quad_count = count;
+	bench.quads = LinceCalloc(sizeof(LinceQuadProps) * count);
+	for(uint32_t i = 0; i != count; ++i){
+		float size = BenchRandRange(0.01f, 0.04f) * bench.cam->scale;
+		bench.quads[i] = (LinceQuadProps){
+			.x = BenchRandRange(-xmax, xmax) + bench.cam->pos[0] * bench.cam->scale,
+			.y = BenchRandRange(-ymax, ymax) + bench.cam->pos[1] * bench.cam->scale,
+			.w = size, .h = size,
+			.zorder = BenchRandRange(0.1f, 0.9f),
+			.color = {BenchRandRange(0.2f, 1.0f), BenchRandRange(0.2f, 1.0f), BenchRandRange(0.2f, 1.0f), 1.0f},
+		};
+		if(bench.texture_count > 0){
+			bench.quads[i].texture = bench.textures[i % bench.texture_count];
+			BenchSetWhite(bench.quads[i].color);
+		}
+	}
+}
+
+/* Creates a tilemap of random tiles from a generated tileset */
+static void BenchCreateTilemap(uint32_t width, uint32_t height){
+	uint32_t size = TILESET_CELLS * TILE_PIXELS;
+	unsigned char* data = LinceMalloc(size * size * 4);
+	for(uint32_t i = 0; i != size * size; ++i){
+		uint32_t cell = (i / size / TILE_PIXELS) * TILESET_CELLS + (i % size) / TILE_PIXELS;
+		data[4*i + 0] = (unsigned char)(cell * 4);
+		data[4*i + 1] = (unsigned char)(255 - cell * 4);
+		data[4*i + 2] = (unsigned char)((i % 7) * 16);
+		data[4*i + 3] = 255;
+	}
+	bench.texture_count = 1;
+	bench.textures = LinceCalloc(sizeof(LinceTexture*));
+	bench.textures[0] = LinceCreateEmptyTexture("bench_tileset", size, size);
+	LinceSetTextureData(bench.textures[0], data);
+	LinceFree(data);
+
+	bench.tiles = LinceCalloc(sizeof(LinceTile) * TILESET_CELLS * TILESET_CELLS);
+	for(uint32_t i = 0; i != TILESET_CELLS * TILESET_CELLS; ++i){
+		bench.tiles[i] = LinceGetTile(bench.textures[0],
+			(vec2){(float)(i % TILESET_CELLS), (float)(i / TILESET_CELLS)},
+			(vec2){TILE_PIXELS, TILE_PIXELS}, (vec2){1, 1}
+		);
+	}
+
+	uint32_t* grid = LinceMalloc(sizeof(uint32_t) * width * height);
+	for(uint32_t i = 0; i != width * height; ++i){
+		grid[i] = BenchRand() % (TILESET_CELLS * TILESET_CELLS);
+	}
+	bench.tilemap = LinceCreateTilemap(&(LinceTilemap){
+		.tileset = bench.tiles,
+		.tileset_size = TILESET_CELLS * TILESET_CELLS,
+		.scale = {1.0f, 1.0f},
+		.width = width,
+		.height = height,
+		.base_grid = grid,
+	});
+	LinceFree(grid);
+}
+
+/* Starts a scene with the given settings and the same random numbers on every run */
+static void BenchBeginInit(const BenchSettings* settings){
+	bench = (BenchState){.settings = *settings, .seed = 12345};
+}
+
+/* Deletes whatever the last scene created */
+static void BenchTerminate(){
+	if(bench.tilemap) LinceDeleteTilemap(bench.tilemap);
+	if(bench.pool) LinceDeleteTexturePool(bench.pool);
+	for(uint32_t i = 0; i != bench.texture_count; ++i){
+		LinceDeleteTexture(bench.textures[i]);
+	}
+	if(bench.textures) LinceFree(bench.textures);
+	if(bench.tiles) LinceFree(bench.tiles);
+	if(bench.quads) LinceFree(bench.quads);
+	for(uint32_t i = 0; i != bench.buffer_count; ++i){
+		LinceDeleteQuadBuffer(bench.buffers[i]);
+	}
+	if(bench.buffers) LinceFree(bench.buffers);
+	if(bench.cam) LinceDeleteCamera(bench.cam);
+	if(bench.hud_cam) LinceDeleteCamera(bench.hud_cam);
+	bench = (BenchState){0};
+}
+
+
+/* --- Untextured quads --- */
+
+static void QuadsInit(const BenchSettings* settings){
+	BenchBeginInit(settings);
+	bench.cam = BenchCreateCamera(1.0f, 0.0f, 0.0f);
+	BenchCreateQuads(settings->quads);
+}
+
+static void QuadsDraw(uint32_t frame){
+	LINCE_UNUSED(frame);
+	LinceBeginScene(bench.cam);
+	for(uint32_t i = 0; i != bench.quad_count; ++i){
+		LinceDrawQuad(bench.quads[i]);
+	}
+	LinceEndScene();
+}
+
+
+/* --- Same quads, recorded by the threads of the job system --- */
+
+static void ThreadedInit(const BenchSettings* settings){
+	QuadsInit(settings);
+	bench.buffer_count = LinceGetJobThreadCount(LinceGetJobSystem());
+	bench.buffers = LinceCalloc(sizeof(LinceQuadBuffer*) * bench.buffer_count);
+	for(uint32_t i = 0; i != bench.buffer_count; ++i){
+		bench.buffers[i] = LinceCreateQuadBuffer();
+	}
+}
+
+/* Records a range of quads into the buffer of the calling thread */
+static void ThreadedRecord(void* data, size_t begin, size_t end){
+	LINCE_UNUSED(data);
+	uint32_t thread = LinceGetJobThreadIndex(LinceGetJobSystem());
+	LinceRecordQuads(bench.buffers[thread], bench.quads + begin, end - begin);
+}
+
+static void ThreadedDraw(uint32_t frame){
+	LINCE_UNUSED(frame);
+	LinceBeginScene(bench.cam);
+	LinceParallelFor(LinceGetJobSystem(), bench.quad_count, 0, ThreadedRecord, NULL);
+	for(uint32_t i = 0; i != bench.buffer_count; ++i){
+		LinceSubmitQuadBuffer(bench.buffers[i]);
+	}
+	LinceEndScene();
+}
+
+
+/* --- Quads across more textures than there are slots --- */
+
+static void TexturedInit(const BenchSettings* settings){
+	BenchBeginInit(settings);
+	bench.cam = BenchCreateCamera(1.0f, 0.0f, 0.0f);
+	BenchCreateTextures(settings->textures, LinceFalse);
+	BenchCreateQuads(settings->quads);
+}
+
+
+/* --- Same quads and textures, with the textures in one pool --- */
+
+static void PooledInit(const BenchSettings* settings){
+	TexturedInit(settings);
+	bench.pool = LinceCreateTexturePool(TEXTURE_SIZE, TEXTURE_SIZE, bench.texture_count);
+	for(uint32_t i = 0; i != bench.texture_count; ++i){
+		LinceAddTextureToPool(bench.pool, bench.textures[i]);
+	}
+}
+
+
+/* --- Rotating translucent sprites --- */
+
+static void SpritesInit(const BenchSettings* settings){
+	BenchBeginInit(settings);
+	bench.cam = BenchCreateCamera(1.0f, 0.0f, 0.0f);
+	BenchCreateTextures(SPRITE_TEXTURES, LinceTrue);
+	BenchCreateQuads(settings->quads);
+	for(uint32_t i = 0; i != bench.quad_count; ++i){
+		bench.quads[i].rotation = BenchRandRange(0.0f, 360.0f);
+	}
+}
+
+static void SpritesDraw(uint32_t frame){
+	LinceBeginScene(bench.cam);
+	for(uint32_t i = 0; i != bench.quad_count; ++i){
+		LinceQuadProps sprite = bench.quads[i];
+		// half of the sprites spin each way
+		sprite.rotation += (float)frame * ((i & 1) ? 2.0f : -2.0f);
+		LinceDrawQuad(sprite);
+	}
+	LinceEndScene();
+}
+
+
+/* --- Tilemap filling the screen --- */
+
+static void TilemapInit(const BenchSettings* settings){
+	BenchBeginInit(settings);
+	float w = (float)settings->map_width, h = (float)settings->map_height;
+	// tiles are one unit wide and centered on their cell
+	bench.cam = BenchCreateCamera(h / 2.0f, w / 2.0f - 0.5f, h / 2.0f - 0.5f);
+	BenchCreateTilemap(settings->map_width, settings->map_height);
+}
+
+static void TilemapDraw(uint32_t frame){
+	LINCE_UNUSED(frame);
+	LinceBeginScene(bench.cam);
+	LinceDrawTilemap(bench.tilemap);
+	LinceEndScene();
+}
+
+
+/* --- World with sprites and a HUD on top --- */
+
+static void MixedInit(const BenchSettings* settings){
+	TilemapInit(settings);
+	bench.hud_cam = BenchCreateCamera(1.0f, 0.0f, 0.0f);
+
+	// sprites walking over the map use the tiles of the tileset
+	BenchCreateQuads(settings->quads / 4);
+	for(uint32_t i = 0; i != bench.quad_count; ++i){
+		bench.quads[i].w = bench.quads[i].h = BenchRandRange(1.0f, 2.0f);
+		bench.quads[i].texture = NULL;
+		bench.quads[i].tile = &bench.tiles[BenchRand() % (TILESET_CELLS * TILESET_CELLS)];
+		BenchSetWhite(bench.quads[i].color);
+	}
+}
+
+/* Draws panels and rows of glyph-sized quads in screen space, as a UI would */
+static void MixedDrawHUD(uint32_t frame){
+	float aspect = (float)bench.settings.width / (float)bench.settings.height;
+	LinceBeginScene(bench.hud_cam);
+	for(uint32_t i = 0; i != HUD_PANELS; ++i){
+		LinceDrawQuad((LinceQuadProps){
+			.x = -aspect + 0.3f + (float)(i % 4) * (aspect - 0.15f) / 2.0f,
+			.y = (i < 4) ? 0.8f : -0.8f,
+			.w = 0.5f, .h = 0.3f, .zorder = 0.5f,
+			.color = {0.1f, 0.1f, 0.2f, 0.7f},
+		});
+	}
+	float glyph = 1.6f * aspect / HUD_COLUMNS;
+	for(uint32_t row = 0; row != HUD_ROWS; ++row){
+		for(uint32_t col = 0; col != HUD_COLUMNS; ++col){
+			// glyphs change every frame, like counters and timers
+			uint32_t c = (row * HUD_COLUMNS + col + frame) % (TILESET_CELLS * TILESET_CELLS);
+			LinceDrawQuad((LinceQuadProps){
+				.x = -0.8f * aspect + (float)col * glyph,
+				.y = 0.6f - (float)row * glyph * 1.2f,
+				.w = glyph * 0.8f, .h = glyph, .zorder = 0.6f,
+				.color = {1.0f, 1.0f, 1.0f, 0.9f},
+				.tile = &bench.tiles[c],
+			});
+		}
+	}
+	LinceEndScene();
+}
+
+static void MixedDraw(uint32_t frame){
+	LinceBeginScene(bench.cam);
+	LinceDrawTilemap(bench.tilemap);
+	for(uint32_t i = 0; i != bench.quad_count; ++i){
+		LinceQuadProps sprite = bench.quads[i];
+		sprite.x += 0.05f * (float)(frame % 100);
+		sprite.zorder = 0.5f;
+		LinceDrawQuad(sprite);
+	}
+	LinceEndScene();
+	MixedDrawHUD(frame);
+}
+
+
+static const BenchScene bench_scenes[] = {
+	{.name = "quads",    .init = QuadsInit,    .draw = QuadsDraw,    .terminate = BenchTerminate},
+	{.name = "threaded", .init = ThreadedInit, .draw = ThreadedDraw, .terminate = BenchTerminate},
+	{.name = "textured", .init = TexturedInit, .draw = QuadsDraw,    .terminate = BenchTerminate},
+	{.name = "pooled",   .init = PooledInit,   .draw = QuadsDraw,    .terminate = BenchTerminate},
+	{.name = "sprites",  .init = SpritesInit,  .draw = SpritesDraw,  .terminate = BenchTerminate},
+	{.name = "tilemap",  .init = TilemapInit,  .draw = TilemapDraw,  .terminate = BenchTerminate},
+	{.name = "mixed",    .init = MixedInit,    .draw = MixedDraw,    .terminate = BenchTerminate},
+};
+
+const BenchScene* GetBenchScenes(uint32_t* count){
+	*count = sizeof(bench_scenes) / sizeof(bench_scenes[0]);
+	return bench_scenes;
+}
@@ -69,7 +69,7 @@ void PrintDebugBkgData(LinceTilemap* tm){
 
 /// NOTE: provide x,y size (in tiles) rather than total length
 LinceTile* LoadTilesFromTexture(const char* texture_file, size_t* length, float px){
-    LinceTexture* tex = LinceCreateTexture("tileset", texture_file);
+    LinceTexture* tex = LinceLoadTexture("tileset", texture_file, LinceTexture_FlipY | LinceTexture_Mipmaps);
     size_t xtiles = tex->width / (uint32_t)px;
     size_t ytiles = tex->height / (uint32_t)px;
     LinceTile tile;
@@ -442,11 +442,13 @@ void EditorLayerOnAttach(LinceLayer* layer) {
     data->cam_speed = 9e-4f;
     data->cam->zoom = 4.0;
 
-    data->tex_front = LinceCreateTexture("PatrickF", "editor/assets/textures/front.png");
-    data->tex_back  = LinceCreateTexture("PatrickB", "editor/assets/textures/back.png");
-    data->tileset = LinceCreateTexture("Tileset", "editor/assets/textures/shubibubi-cozy-farm.png");
-    data->tileset_noflip = LinceLoadTexture("Tileset", "editor/assets/textures/shubibubi-cozy-farm.png", 0);
-    data->walking_tileset = LinceCreateTexture("Walking", "editor/assets/textures/elv-games-movement.png");
+    // mip levels are sampled when zoomed out
+    uint32_t flags = LinceTexture_FlipY | LinceTexture_Mipmaps;
+    data->tex_front = LinceLoadTexture("PatrickF", "editor/assets/textures/front.png", flags);
+    data->tex_back  = LinceLoadTexture("PatrickB", "editor/assets/textures/back.png", flags);
+    data->tileset = LinceLoadTexture("Tileset", "editor/assets/textures/shubibubi-cozy-farm.png", flags);
+    data->tileset_noflip = LinceLoadTexture("Tileset", "editor/assets/textures/shubibubi-cozy-farm.png", LinceTexture_Mipmaps);
+    data->walking_tileset = LinceLoadTexture("Walking", "editor/assets/textures/elv-games-movement.png", flags);
 
     // Tilemap & tileset
     data->tiles = LoadTilesFromTexture(
@@ -728,12 +730,16 @@ void EditorLayerOnEvent(LinceLayer* layer, LinceEvent* event){
         vec2 xy_ind;
         int change_tile = GetTilemapIndexAtMouse(data->tilemap, data->cam, xy_ind);
         if(change_tile == -1 || data->chosen_menu_tile == -1) return;
+        size_t x = (size_t)xy_ind[0], y = (size_t)xy_ind[1];
         if(map_choice == BASE_MAP)
-            data->tilemap->base_grid[change_tile] = data->chosen_menu_tile;
+            LinceSetTilemapCell(data->tilemap, LinceTilemapLayer_Base, x, y,
+                data->chosen_menu_tile);
         else if(map_choice == LOGIC_MAP)
-            data->tilemap->logic_grid[change_tile] = !data->tilemap->logic_grid[change_tile];
+            LinceSetTilemapCell(data->tilemap, LinceTilemapLayer_Logic, x, y,
+                !data->tilemap->logic_grid[change_tile]);
         else if(map_choice == BKG_MAP)
-            data->tilemap->bkg_grid[change_tile] = data->chosen_menu_tile;
+            LinceSetTilemapCell(data->tilemap, LinceTilemapLayer_Bkg, x, y,
+                data->chosen_menu_tile);
     }
 }
 
@@ -19,7 +19,7 @@ void SetupApplication(){
     app->game_terminate = EditorTerminate;
     
     app->enable_profiling = LinceTrue;
-    app->profiler_filename = "tests/profiling/profile.txt";
+    app->profiler_filename = "tests/profiling/profile.json";
 }
 
 
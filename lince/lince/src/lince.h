@@ -8,6 +8,8 @@
 #include "lince/core/layer.h"
 #include "lince/core/app.h"
 #include "lince/core/memory.h"
+#include "lince/core/jobs.h"
+#include "lince/core/timestep.h"
 
 /* Input */
 #include "lince/core/input.h"
@@ -26,10 +28,16 @@
 #include "lince/renderer/vertex_array.h"
 #include "lince/renderer/shader.h"
 #include "lince/renderer/texture.h"
+#include "lince/renderer/cooked_texture.h"
+#include "lince/renderer/block_compression.h"
 #include "lince/renderer/camera.h"
+#include "lince/renderer/transform.h"
+#include "lince/renderer/draw_queue.h"
+#include "lince/renderer/gpu_timer.h"
 
 /* Tilesets & tilemaps */
 #include "lince/tiles/tileset.h"
+#include "lince/tiles/atlas.h"
 #include "lince/tiles/tile_anim.h"
 #include "lince/tiles/tilemap.h"
 
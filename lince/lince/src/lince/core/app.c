@@ -6,6 +6,8 @@
 
 #include "core/app.h"
 #include "renderer/renderer.h"
+#include "renderer/gpu_timer.h"
+#include "renderer/shader.h"
 #include "gui/ui_layer.h"
 #include "core/input.h"
 #include "core/profiler.h"
@@ -25,6 +27,9 @@ static void LinceInit();
 /* Called once per frame, updates window and renders layers */
 static void LinceOnUpdate();
 
+/* Called every fixed timestep, advances the simulation of layers */
+static void LinceOnFixedUpdate(float dt);
+
 /* Shuts down application and frees allocated memory */
 static void LinceTerminate();
 
@@ -104,8 +109,16 @@ void LincePushOverlay(LinceLayer* overlay) {
     LinceLayerStackPush(app.overlay_stack, overlay);
 }
 
+float LinceGetFixedUpdateAlpha(){
+    return app.fixed.alpha;
+}
+
+LinceJobSystem* LinceGetJobSystem(){
+    return app.jobs;
+}
+
 double LinceGetTimeMillis(){
-    return (glfwGetTime() * 1000.0);
+    return LinceGetTimeMillisec();
 }
 
 float LinceGetAspectRatio(){
@@ -157,41 +170,61 @@ static void LinceInit(){
     if (app.screen_height == 0) app.screen_height = 500;
     if (app.title == NULL) app.title = "Lince Window";
     if (app.enable_profiling && app.profiler_filename){
-        app.profiler_file = fopen(app.profiler_filename, "w");
-        LinceSetProfiler(app.profiler_file);
-        if(!app.profiler_file){
+        if(!LinceStartProfiler(app.profiler_filename)){
             LINCE_INFO("Error: unable to open profiling file '%s'\n",
                 app.profiler_filename);
         }
     }
     
     // Create a windowed mode window and its OpenGL context
-    app.window = LinceCreateWindow(app.screen_width, app.screen_height, app.title);
+    uint32_t window_flags = app.headless ? LinceWindow_Headless : LinceWindow_Default;
+    app.window = LinceCreateWindow(
+        app.screen_width, app.screen_height, app.title, window_flags
+    );
     LinceSetMainEventCallback(app.window, LinceOnEvent);
 
     // init layer and overlay stacks
     app.layer_stack = LinceCreateLayerStack();
     app.overlay_stack = LinceCreateLayerStack();
     
+    app.jobs = LinceCreateJobSystem(app.job_threads);
+    LinceSetShaderCacheDir(app.shader_cache_dir);
     LinceInitRenderer(app.window);
-    app.ui = LinceInitUI(app.window->handle);
+    LinceInitGPUTimer();
+    // Nuklear renders through GLFW, which is unavailable in headless mode
+    app.ui = app.headless ? NULL : LinceInitUI(app.window->handle);
     app.running = LinceTrue;
 
     if (app.game_init) app.game_init(); // user may push layers onto stack
+
+    // the first frame measures its timestep from here, not from the start of the clock
+    app.time_ms = (float)LinceGetTimeMillisec();
 }
 
 
 static void LinceOnUpdate(){
     LINCE_PROFILER_START(timer);
+    LinceGPUScope gpu_frame = LinceBeginGPUScope("Frame");
     LinceClear();
 
     // Calculate delta time
-    float new_time_ms = (float)(glfwGetTime() * 1000.0);
+    float new_time_ms = (float)LinceGetTimeMillisec();
     app.dt = new_time_ms - app.time_ms;
     app.time_ms = new_time_ms;
     app.screen_width = app.window->width;
     app.screen_height = app.window->height;
 
+    // spread texture uploads over frames
+    LinceUpdateTextureLoads(LINCE_TEXTURE_UPLOAD_BUDGET);
+
+    // run as many fixed updates as the frame time covers
+    app.fixed.step = app.fixed_timestep;
+    app.fixed.max_steps = app.max_fixed_steps;
+    uint32_t fixed_steps = LinceAdvanceFixedTimestep(&app.fixed, app.dt);
+    for (uint32_t step = 0; step != fixed_steps; ++step) {
+        LinceOnFixedUpdate(app.fixed_timestep);
+    }
+
     LinceBeginUIRender(app.ui);
 
     // update layers
@@ -199,7 +232,10 @@ static void LinceOnUpdate(){
     for (i = 0; i != app.layer_stack->count; ++i) {
         LinceLayer* layer = app.layer_stack->layers[i];
         app.current_layer = i;
-        if (layer && layer->OnUpdate) layer->OnUpdate(layer, app.dt);
+        if (!layer || !layer->OnUpdate) continue;
+        LinceGPUScope gpu_layer = LinceBeginGPUScope("Layer");
+        layer->OnUpdate(layer, app.dt);
+        LinceEndGPUScope(gpu_layer);
     }
     app.current_layer = -1;
 
@@ -207,20 +243,54 @@ static void LinceOnUpdate(){
     for (i = 0; i != app.overlay_stack->count; ++i) {
         LinceLayer* overlay = app.overlay_stack->layers[i];
         app.current_overlay = i;
-        if (overlay && overlay->OnUpdate) overlay->OnUpdate(overlay, app.dt);
+        if (!overlay || !overlay->OnUpdate) continue;
+        LinceGPUScope gpu_overlay = LinceBeginGPUScope("Overlay");
+        overlay->OnUpdate(overlay, app.dt);
+        LinceEndGPUScope(gpu_overlay);
     }
     app.current_overlay = -1;
 
     // update user application
-    if (app.game_on_update) app.game_on_update(app.dt);
+    if (app.game_on_update){
+        LinceGPUScope gpu_game = LinceBeginGPUScope("Game");
+        app.game_on_update(app.dt);
+        LinceEndGPUScope(gpu_game);
+    }
 
+    if (app.show_renderer_stats) LinceUIRendererStats(app.ui, 10, 10);
     LinceEndUIRender(app.ui);
+    LinceEndGPUScope(gpu_frame);
     LinceUpdateWindow(app.window);
+    // reads the GPU times of an earlier frame before the stats are finished
+    LinceEndGPUTimerFrame();
+    LinceEndRendererFrame(app.dt);
+    LINCE_PROFILER_END(timer);
+}
+
+static void LinceOnFixedUpdate(float dt){
+    LINCE_PROFILER_START(timer);
+    unsigned int i;
+    for (i = 0; i != app.layer_stack->count; ++i) {
+        LinceLayer* layer = app.layer_stack->layers[i];
+        app.current_layer = i;
+        if (layer && layer->OnFixedUpdate) layer->OnFixedUpdate(layer, dt);
+    }
+    app.current_layer = -1;
+
+    for (i = 0; i != app.overlay_stack->count; ++i) {
+        LinceLayer* overlay = app.overlay_stack->layers[i];
+        app.current_overlay = i;
+        if (overlay && overlay->OnFixedUpdate) overlay->OnFixedUpdate(overlay, dt);
+    }
+    app.current_overlay = -1;
+
+    if (app.game_on_fixed_update) app.game_on_fixed_update(dt);
     LINCE_PROFILER_END(timer);
 }
 
 static void LinceTerminate(){
 
+    LinceTerminateGPUTimer();
     LinceTerminateRenderer();
     
     // free layer and overlay stacks
@@ -231,6 +301,10 @@ static void LinceTerminate(){
     
     if (app.game_terminate) app.game_terminate();
 
+    // waits for queued jobs, which may still use the context
+    LinceDeleteJobSystem(app.jobs);
+    app.jobs = NULL;
+
     LinceTerminateUI(app.ui);
 
     /* shutdown window last, as it destroys opengl context
@@ -239,7 +313,7 @@ static void LinceTerminate(){
     app.window = NULL;
     app.running = 0;
     
-    LinceSetProfiler(NULL);
+    LinceStopProfiler();
 }
 
 static void LinceOnEvent(LinceEvent* e){
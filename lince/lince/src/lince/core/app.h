@@ -3,6 +3,8 @@
 
 #include "lince/core/window.h"
 #include "lince/core/layer.h"
+#include "lince/core/jobs.h"
+#include "lince/core/timestep.h"
 #include "lince/event/event.h"
 #include "lince/event/key_event.h"
 #include "lince/event/mouse_event.h"
@@ -14,6 +16,7 @@
 /* Function pointer typedefs for user callbacks */
 typedef void (*LinceGameInitFn)();
 typedef void (*LinceGameOnUpdateFn)(float dt);
+typedef void (*LinceGameOnFixedUpdateFn)(float dt);
 typedef void (*LinceGameOnEventFn)(LinceEvent*);
 typedef void (*LinceGameTerminateFn)();
 
@@ -24,15 +27,22 @@ typedef struct LinceApp{
     void* user_data;    // Pointer that may be freely assiged and retrieved by the user
     uint32_t screen_width, screen_height; // Size of the window
     const char* title;  // String of text shown on the top of the window
+    LinceBool headless; // Renders offscreen without a window or display server (no UI)
+    uint32_t job_threads; // Threads of the job system, including the main one. One per core if zero
+    LinceBool show_renderer_stats; // Draws a window with the renderer statistics of each frame
+    float fixed_timestep;     // Time in ms between fixed updates, e.g. 1000/60. Zero disables them
+    uint32_t max_fixed_steps; // Max fixed updates per frame, LINCE_FIXED_UPDATE_MAX_STEPS if zero
+    const char* shader_cache_dir; // Directory where linked shaders are cached between runs. Disabled if NULL
 
     LinceBool enable_profiling;
     LinceBool enable_logging;
-    char* profiler_filename;
+    char* profiler_filename; // Chrome trace file written by the profiler, see LinceStartProfiler
     char* log_filename;
 
     /* User callbacks */
     LinceGameInitFn      game_init;        /* Called on initialisation */
     LinceGameOnUpdateFn  game_on_update;   /* Called once per frame */
+    LinceGameOnFixedUpdateFn game_on_fixed_update; /* Called every fixed timestep */
     LinceGameOnEventFn   game_on_event;    /* Events are passed to this */
     LinceGameTerminateFn game_terminate;   /* Called on program end */
     
@@ -43,11 +53,12 @@ typedef struct LinceApp{
     LinceBool        running;
     float time_ms;          // clock in milliseconds
     float dt;               // timestep in ms
+    LinceFixedTimestep fixed; // time accumulated for fixed updates
     int current_layer;      // index of layer baing updated/handled
     int current_overlay;    // index of layer baing updated/handled
+    LinceJobSystem* jobs;   // worker threads, see LinceGetJobSystem
     
     FILE* log_file;         // FILE object to which logging messages are written
-    FILE* profiler_file;   // FILE object to which benchmarking info is written
     
 
     /* UI */
@@ -76,6 +87,16 @@ double LinceGetTimeMillis();
 /* Returns the current state of the running program */
 LinceApp* LinceGetAppState();
 
+/*
+Returns how far the frame is between the last fixed update and the next one, in [0,1).
+Rendering may interpolate between the last two simulated states with it.
+Zero if fixed updates are disabled.
+*/
+float LinceGetFixedUpdateAlpha();
+
+/* Returns the job system of the app, whose threads run background work */
+LinceJobSystem* LinceGetJobSystem();
+
 /* Returns current aspect ratio of the window */
 float LinceGetAspectRatio();
 
@@ -7,20 +7,22 @@
 
 LinceBool LinceIsKeyPressed(int key){
     GLFWwindow* handle = LinceGetAppState()->window->handle;
+    if(!handle) return LinceFalse; // headless
     int state = glfwGetKey(handle, key);
     return (state == GLFW_PRESS || state == GLFW_REPEAT);
 }
 
 LinceBool LinceIsMouseButtonPressed(int button){
     GLFWwindow* handle = LinceGetAppState()->window->handle;
+    if(!handle) return LinceFalse; // headless
     int state = glfwGetMouseButton(handle, button);
 	return (state == GLFW_PRESS);
 }
 
 void LinceGetMousePos(float* xpos, float* ypos){
-    double x, y;
+    double x = 0.0, y = 0.0;
     GLFWwindow* handle = LinceGetAppState()->window->handle;
-	glfwGetCursorPos(handle, &x, &y);
+	if(handle) glfwGetCursorPos(handle, &x, &y);
     if (xpos) *xpos = (float)x;
     if (ypos) *ypos = (float)y;
 }
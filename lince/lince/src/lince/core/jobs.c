@@ -0,0 +1,389 @@
+#include "core/jobs.h"
+#include "core/memory.h"
+
+#ifdef LINCE_WINDOWS
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+/* --- Platform --- */
+
+#ifdef LINCE_WINDOWS
+typedef CRITICAL_SECTION LinceMutex;
+typedef CONDITION_VARIABLE LinceCondition;
+typedef HANDLE LinceThread;
+#define LINCE_THREAD_LOCAL __declspec(thread)
+
+#define LinceInitMutex(m)        InitializeCriticalSection(m)
+#define LinceDestroyMutex(m)     DeleteCriticalSection(m)
+#define LinceLockMutex(m)        EnterCriticalSection(m)
+#define LinceUnlockMutex(m)      LeaveCriticalSection(m)
+#define LinceInitCondition(c)    InitializeConditionVariable(c)
+#define LinceDestroyCondition(c)
+#define LinceWaitCondition(c, m) SleepConditionVariableCS(c, m, INFINITE)
+#define LinceWakeCondition(c)    WakeConditionVariable(c)
+#define LinceWakeAllCondition(c) WakeAllConditionVariable(c)
+#define LinceYieldThread()       SwitchToThread()
+
+/* Adds to an integer atomically and returns the new value */
+static inline long LinceAtomicAdd(volatile long* x, long n){
+	return InterlockedExchangeAdd(x, n) + n;
+}
+static inline long LinceAtomicLoad(volatile long* x){
+	return InterlockedCompareExchange(x, 0, 0);
+}
+
+#else
+typedef pthread_mutex_t LinceMutex;
+typedef pthread_cond_t LinceCondition;
+typedef pthread_t LinceThread;
+#define LINCE_THREAD_LOCAL _Thread_local
+
+#define LinceInitMutex(m)        pthread_mutex_init(m, NULL)
+#define LinceDestroyMutex(m)     pthread_mutex_destroy(m)
+#define LinceLockMutex(m)        pthread_mutex_lock(m)
+#define LinceUnlockMutex(m)      pthread_mutex_unlock(m)
+#define LinceInitCondition(c)    pthread_cond_init(c, NULL)
+#define LinceDestroyCondition(c) pthread_cond_destroy(c)
+#define LinceWaitCondition(c, m) pthread_cond_wait(c, m)
+#define LinceWakeCondition(c)    pthread_cond_signal(c)
+#define LinceWakeAllCondition(c) pthread_cond_broadcast(c)
+#define LinceYieldThread()       sched_yield()
+
+/* Adds to an integer atomically and returns the new value */
+static inline long LinceAtomicAdd(volatile long* x, long n){
+	return __atomic_add_fetch(x, n, __ATOMIC_SEQ_CST);
+}
+static inline long LinceAtomicLoad(volatile long* x){
+	return __atomic_load_n(x, __ATOMIC_SEQ_CST);
+}
+#endif
+
+
+/* --- Job system --- */
+
+/* Ring buffer of jobs owned by one thread */
+typedef struct LinceJobQueue {
+	LinceMutex lock;
+	LinceJob* jobs;
+	size_t head;     // index of the oldest job
+	size_t count;    // number of queued jobs
+	size_t capacity; // max number of jobs before reallocation
+} LinceJobQueue;
+
+/* Arguments of a worker thread */
+typedef struct LinceJobWorker {
+	LinceJobSystem* sys;
+	uint32_t index;
+} LinceJobWorker;
+
+struct LinceJobSystem {
+	uint32_t thread_count;
+	LinceThread* threads;    // worker threads, the first one is the creating thread
+	LinceJobWorker* workers; // arguments of each thread
+	LinceJobQueue* queues;   // one queue per thread
+	volatile long pending;   // number of queued jobs not yet taken
+	volatile long unfinished; // number of jobs queued or running
+	volatile long sleeping;  // number of workers waiting for jobs
+	volatile long running;   // cleared when the system is deleted
+	LinceMutex sleep_lock;
+	LinceCondition wake;     // signalled when jobs are queued
+};
+
+/* Job system the current thread belongs to, and the index of its queue */
+static LINCE_THREAD_LOCAL LinceJobSystem* thread_system = NULL;
+static LINCE_THREAD_LOCAL uint32_t thread_index = 0;
+
+/* Threads outside the job system use the queue of the creating thread */
+uint32_t LinceGetJobThreadIndex(LinceJobSystem* sys){
+	return thread_system == sys ? thread_index : 0;
+}
+
+/* Appends a job to a queue, as the newest or as the oldest. Queue must be locked */
+static void LinceQueueJob(LinceJobQueue* q, const LinceJob* job, LinceBool oldest){
+	if(q->count == q->capacity){
+		// unwrap the ring buffer into a larger one
+		size_t capacity = q->capacity ? q->capacity * 2 : 64;
+		LinceJob* jobs = LinceMalloc(capacity * sizeof(LinceJob));
+		for(size_t i = 0; i != q->count; ++i){
+			jobs[i] = q->jobs[(q->head + i) % q->capacity];
+		}
+		LinceFree(q->jobs);
+		q->jobs = jobs;
+		q->head = 0;
+		q->capacity = capacity;
+	}
+	if(oldest){
+		q->head = (q->head + q->capacity - 1) % q->capacity;
+		q->jobs[q->head] = *job;
+	} else {
+		q->jobs[(q->head + q->count) % q->capacity] = *job;
+	}
+	q->count++;
+}
+
+/* Removes the newest job of a queue, or the oldest one if stealing */
+static LinceBool LinceTakeQueuedJob(LinceJobQueue* q, LinceJob* job, LinceBool steal){
+	LinceLockMutex(&q->lock);
+	if(q->count == 0){
+		LinceUnlockMutex(&q->lock);
+		return LinceFalse;
+	}
+	if(steal){
+		*job = q->jobs[q->head];
+		q->head = (q->head + 1) % q->capacity;
+	} else {
+		*job = q->jobs[(q->head + q->count - 1) % q->capacity];
+	}
+	q->count--;
+	LinceUnlockMutex(&q->lock);
+	return LinceTrue;
+}
+
+/* Wakes sleeping workers after `count` jobs have been queued */
+static void LinceWakeJobWorkers(LinceJobSystem* sys, size_t count){
+	LinceAtomicAdd(&sys->pending, (long)count);
+	if(LinceAtomicLoad(&sys->sleeping) == 0) return;
+	LinceLockMutex(&sys->sleep_lock);
+	if(count == 1) LinceWakeCondition(&sys->wake);
+	else LinceWakeAllCondition(&sys->wake);
+	LinceUnlockMutex(&sys->sleep_lock);
+}
+
+/*
+Takes a job from the queue of a thread, or steals one from the others, and runs it.
+Returns false if no job was run.
+*/
+static LinceBool LinceRunPendingJob(LinceJobSystem* sys, uint32_t index){
+	if(LinceAtomicLoad(&sys->pending) <= 0) return LinceFalse;
+
+	// own jobs newest first, which are likely in cache, then the oldest of others
+	LinceJob job;
+	LinceBool found = LinceFalse;
+	for(uint32_t i = 0; i != sys->thread_count && !found; ++i){
+		LinceJobQueue* q = sys->queues + (index + i) % sys->thread_count;
+		found = LinceTakeQueuedJob(q, &job, i != 0);
+	}
+	if(!found) return LinceFalse;
+	LinceAtomicAdd(&sys->pending, -1);
+
+	// not ready, put it back behind the other jobs
+	if(job.dependency && LinceAtomicLoad(&job.dependency->value) > 0){
+		LinceJobQueue* q = sys->queues + index;
+		LinceLockMutex(&q->lock);
+		LinceQueueJob(q, &job, LinceTrue);
+		LinceUnlockMutex(&q->lock);
+		LinceWakeJobWorkers(sys, 1);
+		return LinceFalse;
+	}
+
+	job.fn(job.data);
+	if(job.counter) LinceAtomicAdd(&job.counter->value, -1);
+	LinceAtomicAdd(&sys->unfinished, -1);
+	return LinceTrue;
+}
+
+#ifdef LINCE_WINDOWS
+static DWORD WINAPI LinceJobWorkerMain(LPVOID args){
+#else
+static void* LinceJobWorkerMain(void* args){
+#endif
+	LinceJobWorker* worker = args;
+	LinceJobSystem* sys = worker->sys;
+	thread_system = sys;
+	thread_index = worker->index;
+
+	while(LinceAtomicLoad(&sys->running)){
+		if(LinceRunPendingJob(sys, thread_index)) continue;
+
+		// jobs waiting on dependencies, or taken by other threads meanwhile
+		if(LinceAtomicLoad(&sys->pending) > 0){
+			LinceYieldThread();
+			continue;
+		}
+
+		// sleeping is counted before checking for jobs,
+		// so that threads queueing jobs know to wake this one
+		LinceLockMutex(&sys->sleep_lock);
+		LinceAtomicAdd(&sys->sleeping, 1);
+		while(LinceAtomicLoad(&sys->pending) <= 0 && LinceAtomicLoad(&sys->running)){
+			LinceWaitCondition(&sys->wake, &sys->sleep_lock);
+		}
+		LinceAtomicAdd(&sys->sleeping, -1);
+		LinceUnlockMutex(&sys->sleep_lock);
+	}
+	return 0;
+}
+
+uint32_t LinceGetCoreCount(){
+#ifdef LINCE_WINDOWS
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	long cores = (long)info.dwNumberOfProcessors;
+#else
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	return cores > 0 ? (uint32_t)cores : 1;
+}
+
+LinceJobSystem* LinceCreateJobSystem(uint32_t thread_count){
+	if(thread_count == 0) thread_count = LinceGetCoreCount();
+
+	LinceJobSystem* sys = LinceCalloc(sizeof(LinceJobSystem));
+	sys->thread_count = thread_count;
+	sys->running = 1;
+	sys->threads = LinceCalloc(thread_count * sizeof(LinceThread));
+	sys->workers = LinceCalloc(thread_count * sizeof(LinceJobWorker));
+	sys->queues = LinceCalloc(thread_count * sizeof(LinceJobQueue));
+	LinceInitMutex(&sys->sleep_lock);
+	LinceInitCondition(&sys->wake);
+	for(uint32_t i = 0; i != thread_count; ++i){
+		LinceInitMutex(&sys->queues[i].lock);
+		sys->workers[i] = (LinceJobWorker){.sys = sys, .index = i};
+	}
+
+	// calling thread takes the first queue
+	thread_system = sys;
+	thread_index = 0;
+
+	for(uint32_t i = 1; i != thread_count; ++i){
+#ifdef LINCE_WINDOWS
+		sys->threads[i] = CreateThread(NULL, 0, LinceJobWorkerMain, sys->workers + i, 0, NULL);
+		LINCE_ASSERT(sys->threads[i], "Failed to create worker thread %u", i);
+#else
+		int err = pthread_create(sys->threads + i, NULL, LinceJobWorkerMain, sys->workers + i);
+		LINCE_ASSERT(err == 0, "Failed to create worker thread %u", i);
+		LINCE_UNUSED(err);
+#endif
+	}
+	LINCE_INFO(" Created job system with %u threads", thread_count);
+	return sys;
+}
+
+void LinceDeleteJobSystem(LinceJobSystem* sys){
+	if(!sys) return;
+	uint32_t index = LinceGetJobThreadIndex(sys);
+
+	// finish queued jobs, and wait for running ones, which may still queue more
+	while(LinceAtomicLoad(&sys->unfinished) > 0){
+		if(!LinceRunPendingJob(sys, index)) LinceYieldThread();
+	}
+
+	LinceLockMutex(&sys->sleep_lock);
+	LinceAtomicAdd(&sys->running, -1);
+	LinceWakeAllCondition(&sys->wake);
+	LinceUnlockMutex(&sys->sleep_lock);
+
+	for(uint32_t i = 1; i != sys->thread_count; ++i){
+#ifdef LINCE_WINDOWS
+		WaitForSingleObject(sys->threads[i], INFINITE);
+		CloseHandle(sys->threads[i]);
+#else
+		pthread_join(sys->threads[i], NULL);
+#endif
+	}
+
+	for(uint32_t i = 0; i != sys->thread_count; ++i){
+		LinceDestroyMutex(&sys->queues[i].lock);
+		LinceFree(sys->queues[i].jobs);
+	}
+	LinceDestroyMutex(&sys->sleep_lock);
+	LinceDestroyCondition(&sys->wake);
+	if(thread_system == sys) thread_system = NULL;
+
+	LinceFree(sys->threads);
+	LinceFree(sys->workers);
+	LinceFree(sys->queues);
+	LinceFree(sys);
+}
+
+uint32_t LinceGetJobThreadCount(LinceJobSystem* sys){
+	return sys->thread_count;
+}
+
+void LinceRunJobs(LinceJobSystem* sys, const LinceJob* jobs, size_t count){
+	LINCE_ASSERT(sys && (jobs || count == 0), "Job system or jobs missing");
+	if(count == 0) return;
+
+	for(size_t i = 0; i != count; ++i){
+		LINCE_ASSERT(jobs[i].fn, "Job function missing");
+		if(jobs[i].counter) LinceAtomicAdd(&jobs[i].counter->value, 1);
+	}
+	LinceAtomicAdd(&sys->unfinished, (long)count);
+
+	LinceJobQueue* q = sys->queues + LinceGetJobThreadIndex(sys);
+	LinceLockMutex(&q->lock);
+	for(size_t i = 0; i != count; ++i){
+		LinceQueueJob(q, jobs + i, LinceFalse);
+	}
+	LinceUnlockMutex(&q->lock);
+	LinceWakeJobWorkers(sys, count);
+}
+
+void LinceRunJob(LinceJobSystem* sys, LinceJobFn fn, void* data, LinceJobCounter* counter){
+	LinceJob job = {.fn = fn, .data = data, .counter = counter};
+	LinceRunJobs(sys, &job, 1);
+}
+
+LinceBool LinceIsCounterZero(LinceJobCounter* counter){
+	return LinceAtomicLoad(&counter->value) <= 0;
+}
+
+void LinceWaitForCounter(LinceJobSystem* sys, LinceJobCounter* counter){
+	uint32_t index = LinceGetJobThreadIndex(sys);
+	while(LinceAtomicLoad(&counter->value) > 0){
+		if(!LinceRunPendingJob(sys, index)) LinceYieldThread();
+	}
+}
+
+/* Chunk of a parallel for loop */
+typedef struct LinceParallelForRange {
+	LinceParallelForFn fn;
+	void* data;
+	size_t begin, end;
+} LinceParallelForRange;
+
+static void LinceRunParallelForRange(void* data){
+	LinceParallelForRange* range = data;
+	range->fn(range->data, range->begin, range->end);
+}
+
+void LinceParallelFor(
+	LinceJobSystem* sys, size_t count, size_t grain,
+	LinceParallelForFn fn, void* data
+){
+	LINCE_ASSERT(sys && fn, "Job system or loop function missing");
+	if(count == 0) return;
+
+	// a few chunks per thread, so that faster threads can steal the rest
+	if(grain == 0) grain = count / (sys->thread_count * 4);
+	if(grain == 0) grain = 1;
+
+	size_t chunks = (count + grain - 1) / grain;
+	if(chunks == 1){
+		fn(data, 0, count);
+		return;
+	}
+
+	LinceJobCounter counter = {0};
+	LinceParallelForRange* ranges = LinceMalloc(chunks * sizeof(LinceParallelForRange));
+	LinceJob* jobs = LinceMalloc(chunks * sizeof(LinceJob));
+	for(size_t i = 0; i != chunks; ++i){
+		size_t end = (i + 1) * grain;
+		ranges[i] = (LinceParallelForRange){
+			.fn = fn, .data = data,
+			.begin = i * grain, .end = end < count ? end : count
+		};
+		jobs[i] = (LinceJob){
+			.fn = LinceRunParallelForRange, .data = ranges + i, .counter = &counter
+		};
+	}
+	LinceRunJobs(sys, jobs, chunks);
+	LinceFree(jobs);
+
+	LinceWaitForCounter(sys, &counter);
+	LinceFree(ranges);
+}
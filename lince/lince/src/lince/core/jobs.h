@@ -0,0 +1,88 @@
+#ifndef LINCE_JOBS_H
+#define LINCE_JOBS_H
+
+#include "lince/core/core.h"
+
+/* Function run by a job, which receives the user data of the job */
+typedef void (*LinceJobFn)(void* data);
+
+/* Function run by a parallel for loop on the range of indices [begin, end) */
+typedef void (*LinceParallelForFn)(void* data, size_t begin, size_t end);
+
+/*
+Number of jobs that have not finished yet.
+Jobs decrement their counter when they finish, and other jobs
+may wait until it reaches zero before starting.
+Must be zero-initialised and outlive the jobs that use it.
+*/
+typedef struct LinceJobCounter {
+	volatile long value;
+} LinceJobCounter;
+
+/* Unit of work run by one of the threads of a job system */
+typedef struct LinceJob {
+	LinceJobFn fn;
+	void* data;
+	LinceJobCounter* counter;    // decremented when the job finishes, may be NULL
+	LinceJobCounter* dependency; // job starts once this reaches zero, may be NULL
+} LinceJob;
+
+/*
+Pool of worker threads that run jobs.
+Each thread has a queue of jobs, and idle threads steal jobs from the queues of others.
+The thread that creates the system counts as one of its threads,
+and runs jobs while waiting on counters.
+*/
+typedef struct LinceJobSystem LinceJobSystem;
+
+/* Returns the number of logical cores of the machine */
+uint32_t LinceGetCoreCount();
+
+/*
+Creates a job system with `thread_count` threads, including the calling one.
+If zero, one thread is used per core.
+*/
+LinceJobSystem* LinceCreateJobSystem(uint32_t thread_count);
+
+/* Waits for all jobs to finish, including those queued by running jobs, stops the threads, and deletes the job system */
+void LinceDeleteJobSystem(LinceJobSystem* sys);
+
+/* Returns the number of threads of a job system, including the one that created it */
+uint32_t LinceGetJobThreadCount(LinceJobSystem* sys);
+
+/*
+Returns the index of the calling thread in a job system, from zero to the thread count.
+The thread that created the system, and threads outside it, get zero.
+*/
+uint32_t LinceGetJobThreadIndex(LinceJobSystem* sys);
+
+/*
+Queues jobs to be run on any thread of the job system.
+The counter of each job is incremented before it is queued.
+May be called from any thread, including from within jobs.
+*/
+void LinceRunJobs(LinceJobSystem* sys, const LinceJob* jobs, size_t count);
+
+/* Queues a single job without dependencies */
+void LinceRunJob(LinceJobSystem* sys, LinceJobFn fn, void* data, LinceJobCounter* counter);
+
+/* Returns true if a counter has reached zero, without waiting */
+LinceBool LinceIsCounterZero(LinceJobCounter* counter);
+
+/*
+Returns once a counter reaches zero.
+The calling thread runs queued jobs in the meantime,
+so that jobs may wait on the jobs they started.
+*/
+void LinceWaitForCounter(LinceJobSystem* sys, LinceJobCounter* counter);
+
+/*
+Splits the range [0, count) into chunks of `grain` indices, runs each one as a job,
+and waits for them to finish. If `grain` is zero, it is chosen from the number of threads.
+*/
+void LinceParallelFor(
+	LinceJobSystem* sys, size_t count, size_t grain,
+	LinceParallelForFn fn, void* data
+);
+
+#endif /* LINCE_JOBS_H */
@@ -18,6 +18,9 @@ typedef struct LinceLayer {
 	void (*OnDetach)(struct LinceLayer*);
 	/* called on each game frame */
 	void (*OnUpdate)(struct LinceLayer*, float dt);
+	/* called zero or more times per frame before OnUpdate, with the fixed timestep
+	of the app (see LinceApp.fixed_timestep), to advance the simulation */
+	void (*OnFixedUpdate)(struct LinceLayer*, float dt);
 	/* called only when an event takes place and hasn't been handled yet */
 	void (*OnEvent)(struct LinceLayer*, LinceEvent*);
 } LinceLayer;
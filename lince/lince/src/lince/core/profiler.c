@@ -1,23 +1,394 @@
 #include "core/profiler.h"
 
 #include <GLFW/glfw3.h>
+#include <stdlib.h>
+#include <string.h>
 
-static FILE* outfile = NULL;
+#ifdef LINCE_WINDOWS
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
 
-FILE* LinceGetProfiler(){
-	return outfile;
+/* --- Platform --- */
+
+#ifdef LINCE_WINDOWS
+typedef CRITICAL_SECTION LinceMutex;
+typedef HANDLE LinceThread;
+typedef volatile LONG64 LinceAtomic64;
+typedef DWORD LinceThreadKey;
+#define LINCE_THREAD_LOCAL __declspec(thread)
+
+#define LinceInitMutex(m)    InitializeCriticalSection(m)
+#define LinceDestroyMutex(m) DeleteCriticalSection(m)
+#define LinceLockMutex(m)    EnterCriticalSection(m)
+#define LinceUnlockMutex(m)  LeaveCriticalSection(m)
+
+static inline int64_t LinceAtomicLoad64(LinceAtomic64* x){
+	return InterlockedCompareExchange64(x, 0, 0);
+}
+static inline void LinceAtomicStore64(LinceAtomic64* x, int64_t v){
+	InterlockedExchange64(x, v);
+}
+static inline void LinceAtomicAdd64(LinceAtomic64* x, int64_t n){
+	InterlockedExchangeAdd64(x, n);
+}
+static void LinceSleepMillisec(uint32_t ms){
+	Sleep(ms);
+}
+
+/* Fiber local storage calls `fn` with the value of a thread when it exits */
+static LinceBool LinceCreateThreadKey(LinceThreadKey* key, void (*fn)(void*)){
+	*key = FlsAlloc((PFLS_CALLBACK_FUNCTION)fn);
+	return *key != FLS_OUT_OF_INDEXES;
+}
+static void LinceSetThreadKey(LinceThreadKey key, void* value){
+	FlsSetValue(key, value);
+}
+
+#else
+typedef pthread_mutex_t LinceMutex;
+typedef pthread_t LinceThread;
+typedef volatile int64_t LinceAtomic64;
+typedef pthread_key_t LinceThreadKey;
+#define LINCE_THREAD_LOCAL _Thread_local
+
+#define LinceInitMutex(m)    pthread_mutex_init(m, NULL)
+#define LinceDestroyMutex(m) pthread_mutex_destroy(m)
+#define LinceLockMutex(m)    pthread_mutex_lock(m)
+#define LinceUnlockMutex(m)  pthread_mutex_unlock(m)
+
+static inline int64_t LinceAtomicLoad64(LinceAtomic64* x){
+	return __atomic_load_n(x, __ATOMIC_ACQUIRE);
+}
+static inline void LinceAtomicStore64(LinceAtomic64* x, int64_t v){
+	__atomic_store_n(x, v, __ATOMIC_RELEASE);
+}
+static inline void LinceAtomicAdd64(LinceAtomic64* x, int64_t n){
+	__atomic_add_fetch(x, n, __ATOMIC_RELAXED);
+}
+static void LinceSleepMillisec(uint32_t ms){
+	struct timespec ts = {.tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000L};
+	nanosleep(&ts, NULL);
+}
+
+/* Calls `fn` with the value of a thread when it exits */
+static LinceBool LinceCreateThreadKey(LinceThreadKey* key, void (*fn)(void*)){
+	return pthread_key_create(key, fn) == 0;
+}
+static void LinceSetThreadKey(LinceThreadKey key, void* value){
+	pthread_setspecific(key, value);
 }
+#endif
 
-void LinceSetProfiler(FILE* file){
-	if(file && !outfile){
-		outfile = file;
-	} else if(!file && outfile) {
-		fclose(outfile);
-		outfile = NULL;
+
+/* --- Profiler --- */
+
+/* Kinds of recorded events */
+enum LinceProfileEventType {
+	LinceProfileEvent_Scope = 0,
+	LinceProfileEvent_Counter
+};
+
+/* Scope or counter value recorded by a thread */
+typedef struct LinceProfileEvent {
+	const char* name;
+	uint64_t start;      // timestamp in nanoseconds
+	union {
+		uint64_t end;    // timestamp in nanoseconds, for scopes
+		double value;    // for counters
+	};
+	uint32_t depth;      // number of enclosing scopes
+	uint32_t type;       // one of LinceProfileEventType
+} LinceProfileEvent;
+
+/*
+Events recorded by one thread, written by that thread only
+and read by the flushing thread, so that no locks are needed.
+When the thread exits, the ring is released and given to the next new thread.
+*/
+typedef struct LinceProfilerRing {
+	LinceProfileEvent events[LINCE_PROFILER_RING_SIZE];
+	LinceAtomic64 head; // number of events written
+	LinceAtomic64 tail; // number of events read
+	uint32_t thread;    // index of the thread, in order of its first event
+	LinceBool released; // the thread exited, guarded by the profiler lock
+} LinceProfilerRing;
+
+/* Global profiler state */
+static struct {
+	LinceAtomic64 running;
+	LinceAtomic64 dropped; // events lost to full rings
+	LinceMutex lock;       // guards the list of rings
+	LinceBool lock_init;
+	LinceThreadKey ring_key; // releases the ring of a thread when it exits
+	LinceProfilerRing* rings[LINCE_PROFILER_MAX_THREADS];
+	LinceAtomic64 ring_count;
+	uint32_t thread_count; // thread indices given out so far
+	FILE* file;
+	LinceBool first_event; // no comma is written before the first event
+	uint64_t start;        // timestamp when the profiler started
+	LinceThread flusher;
+} profiler = {0};
+
+/* Ring and open scopes of the calling thread */
+static LINCE_THREAD_LOCAL LinceProfilerRing* thread_ring = NULL;
+static LINCE_THREAD_LOCAL uint32_t thread_depth = 0;
+
+/* Ring of scopes measured on the GPU */
+static LinceProfilerRing* gpu_ring = NULL;
+
+/*
+Gives the calling thread the ring of an exited thread, once its events are written,
+or else allocates and registers a new one. Returns NULL if too many threads hold rings.
+*/
+static LinceProfilerRing* LinceCreateProfilerRing(){
+	LinceProfilerRing* ring = NULL;
+	LinceLockMutex(&profiler.lock);
+	int64_t count = LinceAtomicLoad64(&profiler.ring_count);
+	for(int64_t r = 0; r != count && !ring; ++r){
+		LinceProfilerRing* old = profiler.rings[r];
+		if(old->released && LinceAtomicLoad64(&old->tail) == LinceAtomicLoad64(&old->head)){
+			ring = old;
+		}
+	}
+	if(!ring && count < LINCE_PROFILER_MAX_THREADS){
+		ring = calloc(1, sizeof(LinceProfilerRing));
+		if(ring){
+			profiler.rings[count] = ring;
+			LinceAtomicStore64(&profiler.ring_count, count + 1);
+		}
 	}
+	if(ring){
+		ring->released = LinceFalse;
+		ring->thread = profiler.thread_count++;
+	}
+	LinceUnlockMutex(&profiler.lock);
+	return ring;
+}
+
+/* Creates the ring of the calling thread, to be released when the thread exits */
+static LinceProfilerRing* LinceCreateThreadProfilerRing(){
+	LinceProfilerRing* ring = LinceCreateProfilerRing();
+	if(ring) LinceSetThreadKey(profiler.ring_key, ring);
+	return ring;
+}
+
+/* Marks the ring of an exiting thread as free, its remaining events are still written */
+static void LinceReleaseProfilerRing(void* data){
+	LinceProfilerRing* ring = data;
+	LinceLockMutex(&profiler.lock);
+	ring->released = LinceTrue;
+	LinceUnlockMutex(&profiler.lock);
+}
+
+/* Frees the rings of exited threads, once the flusher has stopped */
+static void LinceFreeReleasedProfilerRings(){
+	LinceLockMutex(&profiler.lock);
+	int64_t count = LinceAtomicLoad64(&profiler.ring_count), kept = 0;
+	for(int64_t r = 0; r != count; ++r){
+		LinceProfilerRing* ring = profiler.rings[r];
+		if(ring->released) free(ring);
+		else profiler.rings[kept++] = ring;
+	}
+	LinceAtomicStore64(&profiler.ring_count, kept);
+	LinceUnlockMutex(&profiler.lock);
+}
+
+/* Writes the events of every ring to file */
+static void LinceFlushProfiler(){
+	int64_t count = LinceAtomicLoad64(&profiler.ring_count);
+	for(int64_t r = 0; r != count; ++r){
+		LinceProfilerRing* ring = profiler.rings[r];
+		int64_t head = LinceAtomicLoad64(&ring->head);
+		int64_t tail = LinceAtomicLoad64(&ring->tail);
+		for(; tail != head; ++tail){
+			const LinceProfileEvent* e = &ring->events[tail % LINCE_PROFILER_RING_SIZE];
+			if(e->type == LinceProfileEvent_Counter){
+				fprintf(profiler.file,
+					"%s{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,"
+					"\"pid\":1,\"args\":{\"value\":%.17g}}",
+					profiler.first_event ? "\n" : ",\n", e->name,
+					(double)(e->start - profiler.start) / 1000.0, e->value
+				);
+				profiler.first_event = LinceFalse;
+				continue;
+			}
+			fprintf(profiler.file,
+				"%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+				"\"pid\":1,\"tid\":%u,\"args\":{\"depth\":%u}}",
+				profiler.first_event ? "\n" : ",\n", e->name,
+				(double)(e->start - profiler.start) / 1000.0,
+				(double)(e->end - e->start) / 1000.0,
+				ring->thread, e->depth
+			);
+			profiler.first_event = LinceFalse;
+		}
+		LinceAtomicStore64(&ring->tail, tail);
+	}
+}
+
+/* Writes events to file until the profiler stops */
+#ifdef LINCE_WINDOWS
+static DWORD WINAPI LinceRunProfilerFlusher(LPVOID arg){
+#else
+static void* LinceRunProfilerFlusher(void* arg){
+#endif
+	LINCE_UNUSED(arg);
+	while(LinceAtomicLoad64(&profiler.running)){
+		LinceSleepMillisec(LINCE_PROFILER_FLUSH_MS);
+		LinceFlushProfiler();
+	}
+	return 0;
+}
+
+LinceBool LinceStartProfiler(const char* path){
+	if(LinceIsProfilerRunning()) return LinceFalse;
+	if(!profiler.lock_init){
+		LinceInitMutex(&profiler.lock);
+		if(!LinceCreateThreadKey(&profiler.ring_key, LinceReleaseProfilerRing)){
+			LinceDestroyMutex(&profiler.lock);
+			return LinceFalse;
+		}
+		profiler.lock_init = LinceTrue;
+	}
+	profiler.file = fopen(path, "w");
+	if(!profiler.file) return LinceFalse;
+	fprintf(profiler.file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+	fprintf(profiler.file, "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+		"\"args\":{\"name\":\"GPU\"}}", LINCE_PROFILER_GPU_THREAD);
+	profiler.first_event = LinceFalse;
+	profiler.start = LinceGetProfilerTicks();
+	LinceAtomicStore64(&profiler.dropped, 0);
+
+	// discard events recorded while stopping the last run
+	int64_t count = LinceAtomicLoad64(&profiler.ring_count);
+	for(int64_t r = 0; r != count; ++r){
+		LinceAtomicStore64(&profiler.rings[r]->tail, LinceAtomicLoad64(&profiler.rings[r]->head));
+	}
+
+	LinceAtomicStore64(&profiler.running, 1);
+#ifdef LINCE_WINDOWS
+	profiler.flusher = CreateThread(NULL, 0, LinceRunProfilerFlusher, NULL, 0, NULL);
+	LinceBool started = profiler.flusher != NULL;
+#else
+	LinceBool started = pthread_create(&profiler.flusher, NULL, LinceRunProfilerFlusher, NULL) == 0;
+#endif
+	if(!started){
+		LinceAtomicStore64(&profiler.running, 0);
+		fclose(profiler.file);
+		profiler.file = NULL;
+	}
+	return started;
+}
+
+void LinceStopProfiler(void){
+	if(!LinceIsProfilerRunning()) return;
+	LinceAtomicStore64(&profiler.running, 0);
+#ifdef LINCE_WINDOWS
+	WaitForSingleObject(profiler.flusher, INFINITE);
+	CloseHandle(profiler.flusher);
+#else
+	pthread_join(profiler.flusher, NULL);
+#endif
+	LinceFlushProfiler();
+	LinceFreeReleasedProfilerRings();
+	fprintf(profiler.file, "\n]}\n");
+	fclose(profiler.file);
+	profiler.file = NULL;
+	if(LinceGetProfilerDroppedEvents() > 0){
+		LINCE_INFO(" Profiler dropped %d events", (int)LinceGetProfilerDroppedEvents());
+	}
+}
+
+LinceBool LinceIsProfilerRunning(void){
+	return LinceAtomicLoad64(&profiler.running) != 0;
+}
+
+uint64_t LinceGetProfilerDroppedEvents(void){
+	return (uint64_t)LinceAtomicLoad64(&profiler.dropped);
+}
+
+LinceProfileScope LinceBeginProfileScope(void){
+	if(!LinceIsProfilerRunning()) return (LinceProfileScope){0};
+	LinceProfileScope scope = {.start = LinceGetProfilerTicks(), .depth = thread_depth};
+	thread_depth = scope.depth + 1;
+	return scope;
+}
+
+/* Adds an event to a ring written only by the calling thread, or drops it if full */
+static void LincePushProfileEvent(LinceProfilerRing* ring, const LinceProfileEvent* event){
+	if(!ring){
+		LinceAtomicAdd64(&profiler.dropped, 1);
+		return;
+	}
+	// only this thread moves the head, so it may be read without atomics
+	int64_t head = ring->head;
+	if(head - LinceAtomicLoad64(&ring->tail) >= LINCE_PROFILER_RING_SIZE){
+		LinceAtomicAdd64(&profiler.dropped, 1);
+		return;
+	}
+	ring->events[head % LINCE_PROFILER_RING_SIZE] = *event;
+	LinceAtomicStore64(&ring->head, head + 1);
+}
+
+void LinceEndProfileScope(const char* name, LinceProfileScope scope){
+	if(scope.start == 0) return;
+	uint64_t end = LinceGetProfilerTicks();
+	// restoring the depth keeps it right even if an inner scope was never ended
+	thread_depth = scope.depth;
+
+	if(!thread_ring) thread_ring = LinceCreateThreadProfilerRing();
+	LinceProfileEvent event = {.name = name, .start = scope.start, .end = end, .depth = scope.depth};
+	LincePushProfileEvent(thread_ring, &event);
+}
+
+void LinceRecordProfileCounter(const char* name, double value){
+	if(!LinceIsProfilerRunning()) return;
+	if(!thread_ring) thread_ring = LinceCreateThreadProfilerRing();
+	LinceProfileEvent event = {
+		.name = name, .start = LinceGetProfilerTicks(),
+		.value = value, .type = LinceProfileEvent_Counter
+	};
+	LincePushProfileEvent(thread_ring, &event);
+}
+
+void LinceRecordGPUProfileEvent(const char* name, uint64_t start, uint64_t end, uint32_t depth){
+	if(!LinceIsProfilerRunning()) return;
+	if(!gpu_ring){
+		gpu_ring = LinceCreateProfilerRing();
+		if(gpu_ring) gpu_ring->thread = LINCE_PROFILER_GPU_THREAD;
+	}
+	LinceProfileEvent event = {.name = name, .start = start, .end = end, .depth = depth};
+	LincePushProfileEvent(gpu_ring, &event);
+}
+
+uint64_t LinceGetProfilerTicks(void){
+#ifdef LINCE_WINDOWS
+	static LARGE_INTEGER freq = {0};
+	if(freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	uint64_t t = (uint64_t)now.QuadPart, f = (uint64_t)freq.QuadPart;
+	return (t / f) * 1000000000ULL + (t % f) * 1000000000ULL / f;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
 }
 
 double LinceGetTimeMillisec(void){
+#ifdef LINCE_LINUX
+	// Monotonic clock that works without GLFW (e.g. in headless mode)
+	static double start_ms = -1.0;
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	double now_ms = (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+	if(start_ms < 0.0) start_ms = now_ms;
+	return now_ms - start_ms;
+#else
 	return (glfwGetTime() * 1000.0);
+#endif
 }
-
@@ -4,15 +4,68 @@
 #include <stdio.h>
 #include "lince/core/core.h"
 
-/* Returns the file used by the profiler to save benchmarking stats */
-FILE* LinceGetProfiler();
+/* Number of events each thread can hold before they are written to file */
+#define LINCE_PROFILER_RING_SIZE (1 << 16)
+
+/* Max number of live threads that may record events, rings of exited threads are reused */
+#define LINCE_PROFILER_MAX_THREADS 64
+
+/* Milliseconds between writes of recorded events to file */
+#define LINCE_PROFILER_FLUSH_MS 10
+
+/* Thread ID under which scopes measured on the GPU appear in the trace */
+#define LINCE_PROFILER_GPU_THREAD 1000
+
+/* Open profiling scope, returned by LinceBeginProfileScope */
+typedef struct LinceProfileScope {
+	uint64_t start;  // timestamp in nanoseconds, zero if the profiler was not running
+	uint32_t depth;  // number of scopes open on the thread when this one began
+} LinceProfileScope;
+
+/*
+Starts recording profiling scopes to a file in the Chrome trace event format,
+which can be opened with chrome://tracing or ui.perfetto.dev.
+Each thread records scopes into its own ring buffer, and a background thread
+writes them to the file every LINCE_PROFILER_FLUSH_MS milliseconds.
+If a ring buffer fills up before it is written, new events are dropped.
+Returns false if the file could not be opened or the profiler is already running.
+*/
+LinceBool LinceStartProfiler(const char* path);
+
+/* Writes the remaining events, closes the file, and stops the profiler */
+void LinceStopProfiler(void);
+
+/* Returns true if the profiler is recording events */
+LinceBool LinceIsProfilerRunning(void);
+
+/* Returns the number of events dropped because a ring buffer was full */
+uint64_t LinceGetProfilerDroppedEvents(void);
+
+/* Opens a scope on the calling thread, which does nothing if the profiler is not running */
+LinceProfileScope LinceBeginProfileScope(void);
 
 /*
-Provides a file to which stats are written.
-If the profiler file is already set, it does nothing.
-If the passed file is NULL, the profiler file is closed and set to NULL. 
+Closes a scope and records it with the given name, which must be a string
+that lives until the profiler is stopped, such as a literal or __func__.
 */
-void LinceSetProfiler(FILE* file);
+void LinceEndProfileScope(const char* name, LinceProfileScope scope);
+
+/*
+Records the value of a counter, such as the number of draw calls in a frame.
+Counters appear in the trace as a graph of their values over time.
+The name must be a string that lives until the profiler is stopped.
+*/
+void LinceRecordProfileCounter(const char* name, double value);
+
+/*
+Records a scope measured on the GPU, with timestamps in the clock of LinceGetProfilerTicks.
+It appears in the trace as a separate thread named "GPU".
+Must only be called from one thread, e.g. the one that owns the OpenGL context.
+*/
+void LinceRecordGPUProfileEvent(const char* name, uint64_t start, uint64_t end, uint32_t depth);
+
+/* Returns a monotonic timestamp in nanoseconds */
+uint64_t LinceGetProfilerTicks(void);
 
 /* Returns number of milliseconds the application has been active */
 double LinceGetTimeMillisec(void);
@@ -21,18 +74,21 @@ double LinceGetTimeMillisec(void);
 #ifdef LINCE_PROFILE
 
 	/* Starts profiling block and timer */
-	#define LINCE_PROFILER_START(ms_counter) \
-		double ms_counter = LinceGetTimeMillisec()
-	
-	/* Ends profiling block and saves benchmark to file */
-	#define LINCE_PROFILER_END(ms_counter) \
-		if(LinceGetProfiler()) \
-			fprintf(LinceGetProfiler(), "\"%s\": %.14g\n", \
-			__FUNCTION__, LinceGetTimeMillisec()-ms_counter)
-	
+	#define LINCE_PROFILER_START(scope) \
+		LinceProfileScope scope = LinceBeginProfileScope()
+
+	/* Ends profiling block and records it under the name of the function */
+	#define LINCE_PROFILER_END(scope) \
+		LinceEndProfileScope(__func__, scope)
+
+	/* Records the value of a counter */
+	#define LINCE_PROFILER_COUNTER(name, value) \
+		LinceRecordProfileCounter(name, (double)(value))
+
 #else
-	#define LINCE_PROFILER_START(ms_counter)
-	#define LINCE_PROFILER_END(file, ms_counter)
+	#define LINCE_PROFILER_START(scope)
+	#define LINCE_PROFILER_END(scope)
+	#define LINCE_PROFILER_COUNTER(name, value)
 #endif
 
-#endif /* LINCE_PROFILER_H */
\ No newline at end of file
+#endif /* LINCE_PROFILER_H */
@@ -0,0 +1,29 @@
+#include "core/timestep.h"
+
+#include <math.h>
+
+uint32_t LinceAdvanceFixedTimestep(LinceFixedTimestep* ts, float dt){
+	if(!ts || ts->step <= 0.0f){
+		if(ts) ts->alpha = 0.0f;
+		return 0;
+	}
+	uint32_t max_steps = ts->max_steps ? ts->max_steps : LINCE_FIXED_UPDATE_MAX_STEPS;
+	if(dt > 0.0f) ts->accumulator += dt;
+
+	// counted as a float, as long hitches may overflow an integer
+	float due = floorf(ts->accumulator / ts->step);
+	if(due > (float)max_steps){
+		// keeps the fraction of a step so that the next frame stays in phase
+		float extra = (due - (float)max_steps) * ts->step;
+		ts->dropped_ms += extra;
+		ts->accumulator -= extra;
+		due = (float)max_steps;
+	}
+	uint32_t count = (uint32_t)due;
+	ts->accumulator -= (float)count * ts->step;
+	if(ts->accumulator < 0.0f) ts->accumulator = 0.0f; // rounding
+	ts->steps += count;
+	ts->alpha = ts->accumulator / ts->step;
+	if(ts->alpha >= 1.0f) ts->alpha = 0.0f;
+	return count;
+}
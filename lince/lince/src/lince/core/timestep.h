@@ -0,0 +1,32 @@
+#ifndef LINCE_TIMESTEP_H
+#define LINCE_TIMESTEP_H
+
+#include "lince/core/core.h"
+
+/* Max number of fixed updates run in one frame, if not set */
+#define LINCE_FIXED_UPDATE_MAX_STEPS 5
+
+/*
+Accumulates frame time and splits it into updates of a fixed timestep,
+so that a simulation runs at the same rate whatever the frame rate.
+Time left over between updates carries on to the next frame.
+*/
+typedef struct LinceFixedTimestep {
+	float step;         // time between fixed updates in ms, zero disables them
+	uint32_t max_steps; // max updates per frame, LINCE_FIXED_UPDATE_MAX_STEPS if zero
+	float accumulator;  // time not yet simulated in ms, always below one step
+	float alpha;        // fraction of a step simulated ahead of the frame, in [0,1)
+	uint64_t steps;     // fixed updates run so far
+	double dropped_ms;  // time discarded when frames needed more than `max_steps` updates
+} LinceFixedTimestep;
+
+/*
+Adds the time of a frame in ms and returns the number of fixed updates to run.
+If more than `max_steps` are due, e.g. after a hitch, the extra time is discarded
+so that the simulation does not fall further behind trying to catch up.
+Afterwards, `alpha` holds how far the frame is into the next step,
+to interpolate between the last two simulated states when rendering.
+*/
+uint32_t LinceAdvanceFixedTimestep(LinceFixedTimestep* ts, float dt);
+
+#endif /* LINCE_TIMESTEP_H */
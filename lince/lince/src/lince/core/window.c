@@ -10,6 +10,11 @@
 #include "event/mouse_event.h"
 #include "event/window_event.h"
 
+#ifdef LINCE_LINUX
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
 
 static void GLFWErrorCallback(int error, const char* description) {
     LINCE_INFO("GLFW ERROR %d -> ", error);
@@ -34,11 +39,117 @@ static void LinceInitGLContext(GLFWwindow* handle){
     LINCE_INFO("OpenGL Version: %s", glGetString(GL_VERSION));
 }
 
+/* Creates the framebuffer that stands in for the window surface in headless mode */
+static void LinceInitOffscreenFramebuffer(LinceWindow* window){
+    glGenRenderbuffers(1, &window->color_buffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, window->color_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, window->width, window->height);
+
+    glGenRenderbuffers(1, &window->depth_buffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, window->depth_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, window->width, window->height);
+
+    glGenFramebuffers(1, &window->framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, window->framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+        GL_RENDERBUFFER, window->color_buffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+        GL_RENDERBUFFER, window->depth_buffer);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    LINCE_ASSERT(status == GL_FRAMEBUFFER_COMPLETE,
+        "Offscreen framebuffer incomplete (status 0x%x)", (int)status);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+}
+
+/*
+Creates an OpenGL context without a window or a display server,
+using the EGL surfaceless platform (e.g. Mesa's llvmpipe on CI machines).
+*/
+static LinceWindow* LinceCreateHeadlessWindow(unsigned int width, unsigned int height){
+#ifdef LINCE_LINUX
+    EGLDisplay display = EGL_NO_DISPLAY;
+    PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if(get_platform_display){
+        display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    }
+    if(display == EGL_NO_DISPLAY) display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    LINCE_ASSERT(display != EGL_NO_DISPLAY, "[EGL] Failed to get a display");
+
+    EGLint egl_major, egl_minor;
+    LINCE_ASSERT(eglInitialize(display, &egl_major, &egl_minor),
+        "[EGL] Failed to initialise (error 0x%x)", (int)eglGetError());
+    LINCE_ASSERT(eglBindAPI(EGL_OPENGL_API), "[EGL] OpenGL API unavailable");
+    LINCE_INFO("EGL Version %d.%d", (int)egl_major, (int)egl_minor);
+
+    // Configs are optional on surfaceless contexts
+    const EGLint config_attribs[] = {
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config = NULL;
+    EGLint config_count = 0;
+    eglChooseConfig(display, config_attribs, &config, 1, &config_count);
+    
+    /* Using OpenGL 4.5, same as windowed mode */
+    const EGLint context_attribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 5,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display,
+        config_count > 0 ? config : (EGLConfig)0, EGL_NO_CONTEXT, context_attribs);
+    LINCE_ASSERT(context != EGL_NO_CONTEXT,
+        "[EGL] Failed to create context (error 0x%x)", (int)eglGetError());
+    LINCE_ASSERT(eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context),
+        "[EGL] Failed to make surfaceless context current");
+
+    int status = gladLoadGLLoader((GLADloadproc)eglGetProcAddress);
+    LINCE_ASSERT(status, "[GLAD] Fatal error: failed to load!");
+
+    LINCE_INFO("GPU: %s", glGetString(GL_RENDERER));
+    LINCE_INFO("Vendor: %s", glGetString(GL_VENDOR));
+    LINCE_INFO("OpenGL Version: %s", glGetString(GL_VERSION));
+
+    LinceWindow* window = malloc(sizeof(LinceWindow));
+    LINCE_ASSERT(window, "Failed to allocate memory");
+    *window = (LinceWindow){
+        .handle = NULL,
+        .height = height,
+        .width = width,
+        .initialised = 0,
+        .title = "Lince Window",
+        .event_callback = NULL,
+        .flags = LinceWindow_Headless,
+        .egl_display = display,
+        .egl_context = context,
+    };
+
+    LinceInitOffscreenFramebuffer(window);
+    glViewport(0, 0, width, height);
+    LINCE_INFO("Headless window %dx%d created", width, height);
+    return window;
+#else
+    LINCE_ASSERT(0, "Headless mode is only supported on Linux");
+    LINCE_UNUSED(width);
+    LINCE_UNUSED(height);
+    return NULL;
+#endif
+}
+
 
 /* Public API */
 
-/// TODO: third argument bit flags for fullscreen, vsync, etc
-LinceWindow* LinceCreateWindow(unsigned int width, unsigned int height, const char* title){
+/// TODO: more flags for fullscreen, vsync, etc
+LinceWindow* LinceCreateWindow(
+    unsigned int width, unsigned int height,
+    const char* title, uint32_t flags
+){
+    if(flags & LinceWindow_Headless){
+        return LinceCreateHeadlessWindow(width, height);
+    }
 
     LINCE_ASSERT(glfwInit(), "Failed to initialise GLFW");
     
@@ -71,7 +182,8 @@ LinceWindow* LinceCreateWindow(unsigned int width, unsigned int height, const ch
         .width = width,
         .initialised = 1,
         .title = "Lince Window",
-        .event_callback = NULL
+        .event_callback = NULL,
+        .flags = flags
     };
 
     glfwSetWindowUserPointer((GLFWwindow*)window->handle, window);
@@ -83,15 +195,46 @@ LinceWindow* LinceCreateWindow(unsigned int width, unsigned int height, const ch
 }
 
 unsigned int LinceShouldCloseWindow(LinceWindow* window){
+    if(LinceIsWindowHeadless(window)) return 0;
     return glfwWindowShouldClose((GLFWwindow*)(window->handle));
 }
 
 void LinceUpdateWindow(LinceWindow* window){
+    if(LinceIsWindowHeadless(window)){
+        glFlush(); // nothing to present, no events to poll
+        return;
+    }
     glfwSwapBuffers(window->handle);
 	glfwPollEvents();
 }
 
+LinceBool LinceIsWindowHeadless(LinceWindow* window){
+    return window && (window->flags & LinceWindow_Headless);
+}
+
+void LinceReadWindowPixels(LinceWindow* window, unsigned char* pixels){
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    if(LinceIsWindowHeadless(window)){
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, window->framebuffer);
+    }
+    glReadPixels(0, 0, window->width, window->height,
+        GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+}
+
 void LinceDestroyWindow(LinceWindow* window){
+    if(LinceIsWindowHeadless(window)){
+        glDeleteFramebuffers(1, &window->framebuffer);
+        glDeleteRenderbuffers(1, &window->color_buffer);
+        glDeleteRenderbuffers(1, &window->depth_buffer);
+#ifdef LINCE_LINUX
+        eglMakeCurrent(window->egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(window->egl_display, window->egl_context);
+        eglTerminate(window->egl_display);
+#endif
+        free(window);
+        return;
+    }
+
     glfwSetErrorCallback(NULL); // otherwise GLFW throws an error on shutdown
     if (window->initialised) glfwTerminate();
     if (window->handle) glfwDestroyWindow((GLFWwindow*)(window->handle));
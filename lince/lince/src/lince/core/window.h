@@ -5,15 +5,36 @@
 
 typedef void (*LinceEventCallbackFn)(LinceEvent*);
 
+typedef enum LinceWindowFlags {
+    LinceWindow_Default  = 0x0,
+    LinceWindow_Headless = 0x1, // no window or display server, renders to an offscreen framebuffer
+} LinceWindowFlags;
+
 typedef struct {
     void* handle;
     unsigned int height, width, initialised;
     char title[LINCE_NAME_MAX];
     LinceEventCallbackFn event_callback;
+    uint32_t flags;
+
+    /* Headless mode */
+    void* egl_display;          // EGL display used in place of a GLFW window
+    void* egl_context;          // surfaceless OpenGL context
+    unsigned int framebuffer;   // offscreen framebuffer that replaces the window surface
+    unsigned int color_buffer;  // RGBA8 renderbuffer attached to the framebuffer
+    unsigned int depth_buffer;  // depth-stencil renderbuffer attached to the framebuffer
 } LinceWindow; 
 
-/* Initialises GLFW window */
-LinceWindow* LinceCreateWindow(unsigned int width, unsigned int height, const char* title);
+/*
+Initialises GLFW window.
+With the flag `LinceWindow_Headless`, no window is created:
+an OpenGL context is created via EGL without a display server
+and rendering goes to an offscreen framebuffer of the given size.
+*/
+LinceWindow* LinceCreateWindow(
+    unsigned int width, unsigned int height,
+    const char* title, uint32_t flags
+);
 
 /* Signals whether the window should be shutdown */
 unsigned int LinceShouldCloseWindow(LinceWindow* window);
@@ -24,6 +45,16 @@ void LinceUpdateWindow(LinceWindow* window);
 /* Shutds down window */
 void LinceDestroyWindow(LinceWindow* window);
 
+/* Returns true if the window renders offscreen without a display */
+LinceBool LinceIsWindowHeadless(LinceWindow* window);
+
+/*
+Copies the current contents of the window's framebuffer
+as tightly packed RGBA8 pixels, starting from the lower left corner.
+The buffer must hold at least width * height * 4 bytes.
+*/
+void LinceReadWindowPixels(LinceWindow* window, unsigned char* pixels);
+
 /* Set the function called every time an event occurs,
 which then propagates it to other callbacks */
 void LinceSetMainEventCallback(LinceWindow* window, LinceEventCallbackFn func);
@@ -1,4 +1,6 @@
 #include "gui/ui_layer.h"
+#include "renderer/renderer.h"
+#include "renderer/gpu_timer.h"
 
 #include "event/event.h"
 #include "event/key_event.h"
@@ -52,16 +54,20 @@ LinceUILayer* LinceInitUI(void* glfw_window){
 }
 
 void LinceBeginUIRender(LinceUILayer* ui){
+	if(!ui) return;
 	nk_glfw3_new_frame(ui->glfw);
 }
 
 void LinceEndUIRender(LinceUILayer* ui){
+	if(!ui) return;
+	LinceGPUScope gpu_scope = LinceBeginGPUScope("LinceEndUIRender");
 	nk_glfw3_render(ui->glfw, NK_ANTI_ALIASING_ON, MAX_VERTEX_BUFFER, MAX_ELEMENT_BUFFER);
+	LinceEndGPUScope(gpu_scope);
 }
 
 void LinceUIOnEvent(LinceUILayer* ui, LinceEvent* event){
+    if(!ui || event->handled == LinceTrue) return;
     void* win = ui->glfw_window;
-    if(event->handled == LinceTrue) return;
 
     event->handled = (LinceBool)nk_item_is_any_active(ui->ctx);
     if(!event->handled) return; // No widget active
@@ -136,3 +142,25 @@ void LinceUIText(
     ctx->style.window.fixed_background = style_state;
 }
 
+void LinceUIRendererStats(LinceUILayer* ui, float x, float y){
+    if(!ui) return;
+    struct nk_context* ctx = ui->ctx;
+    LinceRendererStats stats = LinceGetRendererStats();
+
+    nk_style_set_font(ctx, &ui->fonts[LinceFont_Droid15]->handle);
+    nk_flags flags = NK_WINDOW_BORDER | NK_WINDOW_MOVABLE | NK_WINDOW_TITLE | NK_WINDOW_MINIMIZABLE;
+    if(nk_begin(ctx, "Renderer Stats", nk_rect(x, y, 230, 280), flags)){
+        nk_layout_row_dynamic(ctx, 18, 1);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Frame: %.2f ms", stats.frame_ms);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Min/avg: %.2f / %.2f ms", stats.frame_min_ms, stats.frame_avg_ms);
+        nk_labelf(ctx, NK_TEXT_LEFT, "99th percentile: %.2f ms", stats.frame_p99_ms);
+        nk_labelf(ctx, NK_TEXT_LEFT, "GPU: %.2f ms", stats.gpu_ms);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Scenes: %d", (int)stats.scenes);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Quads: %d (%d culled)", (int)stats.quads_drawn, (int)stats.quads_culled);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Batches: %d", (int)stats.batches);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Draw calls: %d", (int)stats.draw_calls);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Texture binds: %d", (int)stats.texture_binds);
+        nk_labelf(ctx, NK_TEXT_LEFT, "Uploaded: %.1f KB", (double)stats.bytes_uploaded / 1024.0);
+    }
+    nk_end(ctx);
+}
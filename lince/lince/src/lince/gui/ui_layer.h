@@ -47,4 +47,7 @@ void LinceUIText(
     ...                  /* varargs */
 );
 
+/* Draws a movable window with the renderer statistics of the last frame */
+void LinceUIRendererStats(LinceUILayer* ui, float x, float y);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,394 @@
+#include "core/profiler.h"
+#include "renderer/block_compression.h"
+#include <math.h>
+
+/* Interpolation weights out of 64 of BC7 4-bit indices */
+static const int bc7_weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+/*
+Finds the ends of the line that best fits a set of pixels, along their principal axis.
+Only the first `channels` channels are used, and only pixels with `mask` set if not NULL.
+*/
+static void LinceFitBlockEndpoints(
+	const unsigned char pixels[64], const LinceBool mask[16], int channels,
+	float e0[4], float e1[4]
+){
+	float mean[4] = {0}, n = 0.0f;
+	for(int i = 0; i != 16; ++i){
+		if(mask && !mask[i]) continue;
+		for(int c = 0; c != channels; ++c) mean[c] += pixels[i*4 + c];
+		n += 1.0f;
+	}
+	if(n == 0.0f) n = 1.0f;
+	for(int c = 0; c != channels; ++c) mean[c] /= n;
+
+	float cov[4][4] = {{0}};
+	for(int i = 0; i != 16; ++i){
+		if(mask && !mask[i]) continue;
+		float d[4];
+		for(int c = 0; c != channels; ++c) d[c] = pixels[i*4 + c] - mean[c];
+		for(int a = 0; a != channels; ++a){
+			for(int b = 0; b != channels; ++b) cov[a][b] += d[a] * d[b];
+		}
+	}
+
+	// principal axis by power iteration, starting from the pixel furthest from the mean
+	float axis[4] = {0}, furthest = -1.0f;
+	for(int i = 0; i != 16; ++i){
+		if(mask && !mask[i]) continue;
+		float d[4] = {0}, dist = 0.0f;
+		for(int c = 0; c != channels; ++c){
+			d[c] = pixels[i*4 + c] - mean[c];
+			dist += d[c] * d[c];
+		}
+		if(dist > furthest){
+			furthest = dist;
+			memcpy(axis, d, sizeof(d));
+		}
+	}
+	for(int it = 0; it != 8; ++it){
+		float next[4] = {0}, len = 0.0f;
+		for(int a = 0; a != channels; ++a){
+			for(int b = 0; b != channels; ++b) next[a] += cov[a][b] * axis[b];
+			len += next[a] * next[a];
+		}
+		if(len < 1e-12f) break;
+		len = 1.0f / sqrtf(len);
+		for(int c = 0; c != channels; ++c) axis[c] = next[c] * len;
+	}
+
+	// extent of the pixels along the axis
+	float tmin = 0.0f, tmax = 0.0f;
+	for(int i = 0; i != 16; ++i){
+		if(mask && !mask[i]) continue;
+		float t = 0.0f;
+		for(int c = 0; c != channels; ++c) t += (pixels[i*4 + c] - mean[c]) * axis[c];
+		if(t < tmin) tmin = t;
+		if(t > tmax) tmax = t;
+	}
+	for(int c = 0; c != channels; ++c){
+		e0[c] = fminf(fmaxf(mean[c] + axis[c] * tmin, 0.0f), 255.0f);
+		e1[c] = fminf(fmaxf(mean[c] + axis[c] * tmax, 0.0f), 255.0f);
+	}
+}
+
+/* Packs an RGB color into 5:6:5 bits */
+static uint16_t LincePack565(const float rgb[3]){
+	uint16_t r = (uint16_t)(rgb[0] * 31.0f / 255.0f + 0.5f);
+	uint16_t g = (uint16_t)(rgb[1] * 63.0f / 255.0f + 0.5f);
+	uint16_t b = (uint16_t)(rgb[2] * 31.0f / 255.0f + 0.5f);
+	return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+/* Expands a 5:6:5 color into 8 bits per channel, as the GPU does */
+static void LinceUnpack565(uint16_t color, int rgb[3]){
+	int r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+/* Encodes the color part of a BC1 or BC3 block, with transparency only for BC1 */
+static void LinceEncodeColorBlock(const unsigned char pixels[64], LinceBool bc1, unsigned char block[8]){
+	// transparent pixels take no part in the color endpoints
+	LinceBool opaque[16];
+	LinceBool any_opaque = LinceFalse, any_transparent = LinceFalse;
+	for(int i = 0; i != 16; ++i){
+		opaque[i] = !bc1 || pixels[i*4 + 3] >= 128;
+		any_opaque = any_opaque || opaque[i];
+		any_transparent = any_transparent || !opaque[i];
+	}
+	if(!any_opaque){
+		// three-color mode, every pixel transparent
+		memset(block, 0, 4);
+		memset(block + 4, 0xFF, 4);
+		return;
+	}
+
+	float e0[4], e1[4];
+	LinceFitBlockEndpoints(pixels, opaque, 3, e0, e1);
+	uint16_t c0 = LincePack565(e0), c1 = LincePack565(e1);
+
+	// four colors if c0 > c1, otherwise three colors and transparent black
+	if(any_transparent ? c0 > c1 : c0 < c1){
+		uint16_t tmp = c0;
+		c0 = c1;
+		c1 = tmp;
+	}
+	int palette[4][3];
+	LinceUnpack565(c0, palette[0]);
+	LinceUnpack565(c1, palette[1]);
+	int colors = 4;
+	if(c0 > c1){
+		for(int c = 0; c != 3; ++c){
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+	} else {
+		for(int c = 0; c != 3; ++c) palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+		colors = 3;
+	}
+
+	uint32_t indices = 0;
+	for(int i = 0; i != 16; ++i){
+		uint32_t best = 3;
+		if(opaque[i]){
+			int best_err = 1 << 30;
+			for(int p = 0; p != colors; ++p){
+				int err = 0;
+				for(int c = 0; c != 3; ++c){
+					int d = pixels[i*4 + c] - palette[p][c];
+					err += d * d;
+				}
+				if(err < best_err){
+					best_err = err;
+					best = (uint32_t)p;
+				}
+			}
+		}
+		indices |= best << (2 * i);
+	}
+
+	block[0] = (unsigned char)(c0 & 0xFF);
+	block[1] = (unsigned char)(c0 >> 8);
+	block[2] = (unsigned char)(c1 & 0xFF);
+	block[3] = (unsigned char)(c1 >> 8);
+	for(int i = 0; i != 4; ++i) block[4 + i] = (unsigned char)(indices >> (8 * i));
+}
+
+void LinceEncodeBC1Block(const unsigned char pixels[64], unsigned char block[8]){
+	LinceEncodeColorBlock(pixels, LinceTrue, block);
+}
+
+void LinceEncodeBC3Block(const unsigned char pixels[64], unsigned char block[16]){
+	int a0 = 0, a1 = 255;
+	for(int i = 0; i != 16; ++i){
+		int a = pixels[i*4 + 3];
+		if(a > a0) a0 = a;
+		if(a < a1) a1 = a;
+	}
+
+	// eight alpha values, as a0 > a1
+	uint64_t indices = 0;
+	if(a0 > a1){
+		int palette[8] = {a0, a1};
+		for(int p = 1; p != 7; ++p) palette[p + 1] = ((7 - p) * a0 + p * a1) / 7;
+		for(int i = 0; i != 16; ++i){
+			int a = pixels[i*4 + 3], best = 0, best_err = 256;
+			for(int p = 0; p != 8; ++p){
+				int err = abs(a - palette[p]);
+				if(err < best_err){
+					best_err = err;
+					best = p;
+				}
+			}
+			indices |= (uint64_t)best << (3 * i);
+		}
+	}
+	block[0] = (unsigned char)a0;
+	block[1] = (unsigned char)a1;
+	for(int i = 0; i != 6; ++i) block[2 + i] = (unsigned char)(indices >> (8 * i));
+
+	// colors of BC3 always use four-color mode
+	LinceEncodeColorBlock(pixels, LinceFalse, block + 8);
+}
+
+/* Decodes the colors of a BC1 or BC3 block, BC1 choosing 3 colors and black if c0 <= c1 */
+static void LinceDecodeColorBlock(const unsigned char block[8], LinceBool bc1, unsigned char pixels[64]){
+	uint16_t c0 = (uint16_t)(block[0] | block[1] << 8);
+	uint16_t c1 = (uint16_t)(block[2] | block[3] << 8);
+	int palette[4][4] = {{0}};
+	LinceUnpack565(c0, palette[0]);
+	LinceUnpack565(c1, palette[1]);
+	palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+	if(!bc1 || c0 > c1){
+		for(int c = 0; c != 3; ++c){
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+	} else {
+		for(int c = 0; c != 3; ++c) palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+		palette[3][3] = 0;
+	}
+
+	uint32_t indices = block[4] | block[5] << 8 | block[6] << 16 | (uint32_t)block[7] << 24;
+	for(int i = 0; i != 16; ++i){
+		const int* color = palette[(indices >> (2 * i)) & 3];
+		for(int c = 0; c != 4; ++c) pixels[i*4 + c] = (unsigned char)color[c];
+	}
+}
+
+void LinceDecodeBC1Block(const unsigned char block[8], unsigned char pixels[64]){
+	LinceDecodeColorBlock(block, LinceTrue, pixels);
+}
+
+void LinceDecodeBC3Block(const unsigned char block[16], unsigned char pixels[64]){
+	LinceDecodeColorBlock(block + 8, LinceFalse, pixels);
+
+	// six interpolated alphas if a0 > a1, otherwise four plus 0 and 255
+	int a0 = block[0], a1 = block[1];
+	int palette[8] = {a0, a1};
+	if(a0 > a1){
+		for(int p = 1; p != 7; ++p) palette[p + 1] = ((7 - p) * a0 + p * a1) / 7;
+	} else {
+		for(int p = 1; p != 5; ++p) palette[p + 1] = ((5 - p) * a0 + p * a1) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+	uint64_t indices = 0;
+	for(int i = 0; i != 6; ++i) indices |= (uint64_t)block[2 + i] << (8 * i);
+	for(int i = 0; i != 16; ++i) pixels[i*4 + 3] = (unsigned char)palette[(indices >> (3 * i)) & 7];
+}
+
+/* Appends the lowest `bits` bits of a value to a block, starting at bit `*pos` */
+static void LinceWriteBlockBits(unsigned char* block, int* pos, uint32_t value, int bits){
+	for(int i = 0; i != bits; ++i, ++(*pos)){
+		if(value & (1u << i)) block[*pos / 8] |= (unsigned char)(1u << (*pos % 8));
+	}
+}
+
+/* Quantizes an endpoint to 7 bits per channel plus the given shared bit */
+static void LinceQuantizeBC7Endpoint(const float e[4], int pbit, int q[4]){
+	for(int c = 0; c != 4; ++c){
+		int x = (int)floorf((e[c] - (float)pbit) / 2.0f + 0.5f);
+		q[c] = x < 0 ? 0 : (x > 127 ? 127 : x);
+	}
+}
+
+/*
+Picks the closest of the 16 colors between two quantized endpoints for each pixel.
+Returns the total squared error.
+*/
+static int LinceFindBC7Indices(
+	const unsigned char pixels[64], int q[2][4], const int p[2], int indices[16]
+){
+	int palette[16][4];
+	for(int c = 0; c != 4; ++c){
+		int a = (q[0][c] << 1) | p[0], b = (q[1][c] << 1) | p[1];
+		for(int i = 0; i != 16; ++i){
+			palette[i][c] = ((64 - bc7_weights[i]) * a + bc7_weights[i] * b + 32) >> 6;
+		}
+	}
+
+	int total = 0;
+	for(int i = 0; i != 16; ++i){
+		int best = 0, best_err = 1 << 30;
+		for(int k = 0; k != 16; ++k){
+			int err = 0;
+			for(int c = 0; c != 4; ++c){
+				int d = pixels[i*4 + c] - palette[k][c];
+				err += d * d;
+			}
+			if(err < best_err){
+				best_err = err;
+				best = k;
+			}
+		}
+		indices[i] = best;
+		total += best_err;
+	}
+	return total;
+}
+
+void LinceEncodeBC7Block(const unsigned char pixels[64], unsigned char block[16]){
+	float e0[4], e1[4];
+	LinceFitBlockEndpoints(pixels, NULL, 4, e0, e1);
+
+	// the shared bits are chosen by trying all four pairs
+	int q[2][4], p[2], indices[16], best_err = -1;
+	for(int pair = 0; pair != 4; ++pair){
+		int tq[2][4], tp[2] = {pair & 1, pair >> 1}, tindices[16];
+		LinceQuantizeBC7Endpoint(e0, tp[0], tq[0]);
+		LinceQuantizeBC7Endpoint(e1, tp[1], tq[1]);
+		int err = LinceFindBC7Indices(pixels, tq, tp, tindices);
+		if(best_err < 0 || err < best_err){
+			best_err = err;
+			memcpy(q, tq, sizeof(q));
+			memcpy(p, tp, sizeof(p));
+			memcpy(indices, tindices, sizeof(indices));
+		}
+	}
+
+	// the index of the first pixel is stored without its top bit
+	if(indices[0] >= 8){
+		for(int c = 0; c != 4; ++c){
+			int tmp = q[0][c];
+			q[0][c] = q[1][c];
+			q[1][c] = tmp;
+		}
+		int tmp = p[0];
+		p[0] = p[1];
+		p[1] = tmp;
+		for(int i = 0; i != 16; ++i) indices[i] = 15 - indices[i];
+	}
+
+	memset(block, 0, 16);
+	int pos = 0;
+	LinceWriteBlockBits(block, &pos, 1u << 6, 7); // mode 6
+	for(int c = 0; c != 4; ++c){
+		LinceWriteBlockBits(block, &pos, (uint32_t)q[0][c], 7);
+		LinceWriteBlockBits(block, &pos, (uint32_t)q[1][c], 7);
+	}
+	LinceWriteBlockBits(block, &pos, (uint32_t)p[0], 1);
+	LinceWriteBlockBits(block, &pos, (uint32_t)p[1], 1);
+	LinceWriteBlockBits(block, &pos, (uint32_t)indices[0], 3);
+	for(int i = 1; i != 16; ++i) LinceWriteBlockBits(block, &pos, (uint32_t)indices[i], 4);
+}
+
+void LinceCompressImage(
+	LinceTextureFormat format, const unsigned char* data,
+	uint32_t width, uint32_t height, unsigned char* blocks
+){
+	LINCE_PROFILER_START(timer);
+	LINCE_ASSERT(format != LinceTextureFormat_RGBA8 && format < LinceTextureFormat_Count,
+		" Texture format %d is not block-compressed", (int)format);
+	size_t block_size = format == LinceTextureFormat_BC1 ? 8 : 16;
+
+	unsigned char pixels[64];
+	for(uint32_t by = 0; by < height; by += 4){
+		for(uint32_t bx = 0; bx < width; bx += 4){
+			// gather the block, clamping at the edges
+			for(uint32_t y = 0; y != 4; ++y){
+				uint32_t sy = by + y < height ? by + y : height - 1;
+				for(uint32_t x = 0; x != 4; ++x){
+					uint32_t sx = bx + x < width ? bx + x : width - 1;
+					memcpy(pixels + (y * 4 + x) * 4, data + ((size_t)sy * width + sx) * 4, 4);
+				}
+			}
+			switch(format){
+				case LinceTextureFormat_BC1: LinceEncodeBC1Block(pixels, blocks); break;
+				case LinceTextureFormat_BC3: LinceEncodeBC3Block(pixels, blocks); break;
+				default:                     LinceEncodeBC7Block(pixels, blocks); break;
+			}
+			blocks += block_size;
+		}
+	}
+	LINCE_PROFILER_END(timer);
+}
+
+void LinceDecompressImage(
+	LinceTextureFormat format, const unsigned char* blocks,
+	uint32_t width, uint32_t height, unsigned char* data
+){
+	LINCE_PROFILER_START(timer);
+	LINCE_ASSERT(format == LinceTextureFormat_BC1 || format == LinceTextureFormat_BC3,
+		" Texture format %d cannot be decompressed", (int)format);
+	size_t block_size = format == LinceTextureFormat_BC1 ? 8 : 16;
+
+	unsigned char pixels[64];
+	for(uint32_t by = 0; by < height; by += 4){
+		for(uint32_t bx = 0; bx < width; bx += 4){
+			if(format == LinceTextureFormat_BC1) LinceDecodeBC1Block(blocks, pixels);
+			else LinceDecodeBC3Block(blocks, pixels);
+			blocks += block_size;
+
+			// pixels past the edges are dropped
+			for(uint32_t y = 0; y != 4 && by + y < height; ++y){
+				for(uint32_t x = 0; x != 4 && bx + x < width; ++x){
+					memcpy(data + ((size_t)(by + y) * width + bx + x) * 4, pixels + (y * 4 + x) * 4, 4);
+				}
+			}
+		}
+	}
+	LINCE_PROFILER_END(timer);
+}
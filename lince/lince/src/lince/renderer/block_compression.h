@@ -0,0 +1,47 @@
+#ifndef LINCE_BLOCK_COMPRESSION_H
+#define LINCE_BLOCK_COMPRESSION_H
+
+#include "lince/renderer/texture.h"
+
+/*
+CPU encoders of block-compressed texture formats, which store blocks of 4x4 pixels
+in 8 bytes (BC1) or 16 bytes (BC3, BC7) instead of 64, and are decoded by the GPU.
+Each block is given as 16 RGBA pixels, row by row.
+*/
+
+/* Encodes colors with 565 endpoints. Pixels with alpha under 128 become transparent */
+void LinceEncodeBC1Block(const unsigned char pixels[64], unsigned char block[8]);
+
+/* Encodes colors as in BC1, plus alpha interpolated between two 8-bit endpoints */
+void LinceEncodeBC3Block(const unsigned char pixels[64], unsigned char block[16]);
+
+/* Encodes RGBA with 8-bit endpoints and 16 interpolation steps (BC7 mode 6) */
+void LinceEncodeBC7Block(const unsigned char pixels[64], unsigned char block[16]);
+
+/*
+Compresses RGBA pixel data of size (w,h) into the given block-compressed format.
+Blocks past the edges repeat the last row and column of pixels.
+The output holds LinceGetTextureLevelSize(format, w, h) bytes.
+*/
+void LinceCompressImage(
+	LinceTextureFormat format, const unsigned char* data,
+	uint32_t width, uint32_t height, unsigned char* blocks
+);
+
+/* Decodes a BC1 block into 16 RGBA pixels */
+void LinceDecodeBC1Block(const unsigned char block[8], unsigned char pixels[64]);
+
+/* Decodes a BC3 block into 16 RGBA pixels */
+void LinceDecodeBC3Block(const unsigned char block[16], unsigned char pixels[64]);
+
+/*
+Decompresses BC1 or BC3 blocks of an image of size (w,h) into RGBA pixel data,
+for drivers without GL_EXT_texture_compression_s3tc.
+The output holds w*h*4 bytes.
+*/
+void LinceDecompressImage(
+	LinceTextureFormat format, const unsigned char* blocks,
+	uint32_t width, uint32_t height, unsigned char* data
+);
+
+#endif /* LINCE_BLOCK_COMPRESSION_H */
@@ -23,6 +23,11 @@ static const LinceBufferElement buffer_types_data[] = {
 
 	{.type=LinceBufferType_Mat3,   .gl_type=GL_FLOAT, .comps=3*3, .bytes=sizeof(float)*3*3},
 	{.type=LinceBufferType_Mat4,   .gl_type=GL_FLOAT, .comps=4*4, .bytes=sizeof(float)*4*4},
+
+	{.type=LinceBufferType_UByte,      .gl_type=GL_UNSIGNED_BYTE,  .comps=1, .bytes=sizeof(uint8_t)},
+	{.type=LinceBufferType_UByte4Norm, .gl_type=GL_UNSIGNED_BYTE,  .comps=4, .bytes=sizeof(uint8_t)*4, .norm=1},
+	{.type=LinceBufferType_UShort,     .gl_type=GL_UNSIGNED_SHORT, .comps=1, .bytes=sizeof(uint16_t)},
+	{.type=LinceBufferType_Half2,      .gl_type=GL_HALF_FLOAT,     .comps=2, .bytes=sizeof(uint16_t)*2},
 };
 
 /* Returns details of a buffer type: component count, size, and OpenGL type */
@@ -38,6 +43,7 @@ void LinceSetupBufferElementData(LinceBufferElement* elem){
 	elem->comps = data.comps;
 	elem->gl_type = data.gl_type;
 	elem->bytes = data.bytes;
+	elem->norm = data.norm;
 }
 
 
@@ -71,6 +77,65 @@ void LinceDeleteVertexBuffer(LinceVertexBuffer vb){
 }
 
 
+/* --- Streaming Vertex Buffer --- */
+
+LinceBool LinceIsStreamBufferSupported(){
+	return (LinceBool)(GLAD_GL_VERSION_4_4 != 0);
+}
+
+LinceStreamBuffer* LinceCreateStreamBuffer(unsigned int segment_size){
+	LINCE_INFO(" Creating Streaming Vertex Buffer (%d x %d bytes) ",
+		LINCE_STREAM_SEGMENTS, (int)segment_size);
+	LINCE_ASSERT(LinceIsStreamBufferSupported(),
+		"Streaming vertex buffers require OpenGL 4.4");
+
+	LinceStreamBuffer* sb = calloc(1, sizeof(LinceStreamBuffer));
+	LINCE_ASSERT_ALLOC(sb, sizeof(LinceStreamBuffer));
+	sb->segment_size = segment_size;
+
+	GLsizeiptr size = (GLsizeiptr)segment_size * LINCE_STREAM_SEGMENTS;
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glGenBuffers(1, &sb->vb);
+	glBindBuffer(GL_ARRAY_BUFFER, sb->vb);
+	glBufferStorage(GL_ARRAY_BUFFER, size, NULL, flags);
+	sb->mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+	LINCE_ASSERT(sb->mapped, "Failed to map streaming vertex buffer");
+	return sb;
+}
+
+void* LinceMapStreamSegment(LinceStreamBuffer* sb){
+	GLsync fence = sb->fences[sb->segment];
+	if(fence){
+		// Only blocks if the GPU has not yet drawn from this segment
+		GLenum status;
+		do {
+			status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		} while(status == GL_TIMEOUT_EXPIRED);
+		LINCE_ASSERT(status != GL_WAIT_FAILED, "Failed to wait on vertex buffer fence");
+		glDeleteSync(fence);
+		sb->fences[sb->segment] = NULL;
+	}
+	return sb->mapped + (size_t)sb->segment * sb->segment_size;
+}
+
+void LinceAdvanceStreamSegment(LinceStreamBuffer* sb){
+	if(sb->fences[sb->segment]) glDeleteSync(sb->fences[sb->segment]);
+	sb->fences[sb->segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	sb->segment = (sb->segment + 1) % LINCE_STREAM_SEGMENTS;
+}
+
+void LinceDeleteStreamBuffer(LinceStreamBuffer* sb){
+	if(!sb) return;
+	for(unsigned int i = 0; i != LINCE_STREAM_SEGMENTS; ++i){
+		if(sb->fences[i]) glDeleteSync(sb->fences[i]);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, sb->vb);
+	glUnmapBuffer(GL_ARRAY_BUFFER);
+	glDeleteBuffers(1, &sb->vb);
+	free(sb);
+}
+
+
 /* --- Index Buffer --- */
 
 LinceIndexBuffer LinceCreateIndexBuffer(unsigned int* data, unsigned int count){
@@ -92,4 +157,34 @@ void LinceUnbindIndexBuffer(){
 
 void LinceDeleteIndexBuffer(LinceIndexBuffer ib){
 	glDeleteBuffers(1, &ib.id);
-}
\ No newline at end of file
+}
+
+
+/* --- Uniform Buffer --- */
+
+LinceUniformBuffer LinceCreateUniformBuffer(void* data, unsigned int size){
+	LINCE_INFO(" Creating Uniform Buffer (%d bytes) ", (int)size);
+	unsigned int id;
+	glCreateBuffers(1, &id);
+	glNamedBufferData(id, size, data, GL_DYNAMIC_DRAW);
+	return (LinceUniformBuffer)id;
+}
+
+void LinceSetUniformBufferData(LinceUniformBuffer ub, unsigned int offset, void* data, unsigned int size){
+	glNamedBufferSubData(ub, offset, size, data);
+}
+
+void LinceBindUniformBufferRange(LinceUniformBuffer ub, unsigned int binding,
+	unsigned int offset, unsigned int size){
+	glBindBufferRange(GL_UNIFORM_BUFFER, binding, ub, offset, size);
+}
+
+unsigned int LinceGetUniformBufferAlignment(){
+	int alignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	return alignment > 0 ? (unsigned int)alignment : 256;
+}
+
+void LinceDeleteUniformBuffer(LinceUniformBuffer ub){
+	glDeleteBuffers(1, &ub);
+}
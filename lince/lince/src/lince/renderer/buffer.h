@@ -12,6 +12,11 @@ typedef enum {
     LinceBufferType_Int,   LinceBufferType_Int2,   LinceBufferType_Int3,   LinceBufferType_Int4,
     LinceBufferType_Float, LinceBufferType_Float2, LinceBufferType_Float3, LinceBufferType_Float4,
     LinceBufferType_Mat3,  LinceBufferType_Mat4,
+    /* Compact types for vertex data */
+    LinceBufferType_UByte,      /* unsigned integer, e.g. texture slot */
+    LinceBufferType_UByte4Norm, /* read as vec4 normalised to [0,1], e.g. RGBA8 color */
+    LinceBufferType_UShort,     /* unsigned integer, e.g. texture slot */
+    LinceBufferType_Half2,      /* read as vec2 from half-precision floats */
     LinceBufferType_Count /* number of buffer data types */
 } LinceBufferType;
 
@@ -24,6 +29,7 @@ typedef struct LinceBufferElement {
     unsigned int comps; /* component count, e.g. Int4 has 4 components */
     unsigned int bytes; /* size in bytes */
     unsigned int offset; /* bytes from front of layout to this element */
+    unsigned int norm; /* integer data is normalised to floats in [0,1] */
 } LinceBufferElement;
 
 /* Returns details of a buffer type: component count, size, and OpenGL type */
@@ -50,6 +56,42 @@ void LinceUnbindVertexBuffer();
 void LinceDeleteVertexBuffer(LinceVertexBuffer vb);
 
 
+/* --- Streaming Vertex Buffer --- */
+
+/* Number of segments in the ring of a streaming vertex buffer */
+#define LINCE_STREAM_SEGMENTS 3
+
+/*
+Vertex buffer persistently mapped into client memory and split into
+a ring of segments. Vertices are written straight into the current segment,
+and each segment is fenced after it is drawn, so that the CPU only waits
+if it catches up with a segment the GPU is still reading.
+Requires OpenGL 4.4 (glBufferStorage).
+*/
+typedef struct LinceStreamBuffer {
+    LinceVertexBuffer vb;     // OpenGL renderer ID
+    unsigned char* mapped;    // persistently mapped memory for all segments
+    unsigned int segment_size; // size in bytes of a single segment
+    unsigned int segment;      // index of the segment currently being written
+    void* fences[LINCE_STREAM_SEGMENTS]; // GLsync objects, NULL if segment is free
+} LinceStreamBuffer;
+
+/* Returns true if the OpenGL context supports streaming vertex buffers */
+LinceBool LinceIsStreamBufferSupported();
+
+/* Allocates a persistently mapped vertex buffer with LINCE_STREAM_SEGMENTS segments */
+LinceStreamBuffer* LinceCreateStreamBuffer(unsigned int segment_size);
+
+/* Waits until the GPU is done with the current segment and returns its memory */
+void* LinceMapStreamSegment(LinceStreamBuffer* sb);
+
+/* Fences the current segment after its draw calls and moves on to the next one */
+void LinceAdvanceStreamSegment(LinceStreamBuffer* sb);
+
+/* Unmaps and deletes the buffer and its fences */
+void LinceDeleteStreamBuffer(LinceStreamBuffer* sb);
+
+
 /* --- Index Buffer --- */
 
 typedef struct LinceIndexBuffer {
@@ -63,4 +105,29 @@ void LinceUnbindIndexBuffer();
 void LinceDeleteIndexBuffer(LinceIndexBuffer ib);
 
 
+/* --- Uniform Buffer --- */
+
+/* Stores OpenGL renderer ID of a buffer of uniform data shared between shaders */
+typedef unsigned int LinceUniformBuffer;
+
+/* Creates a uniform buffer of a given size, the supplied data may be empty (NULL) */
+LinceUniformBuffer LinceCreateUniformBuffer(void* data, unsigned int size);
+
+/* Overwrites part of a uniform buffer, starting at `offset` bytes */
+void LinceSetUniformBufferData(LinceUniformBuffer ub, unsigned int offset, void* data, unsigned int size);
+
+/*
+Binds a range of a uniform buffer to a binding point,
+from which the uniform blocks of shaders read.
+The offset must be a multiple of LinceGetUniformBufferAlignment.
+*/
+void LinceBindUniformBufferRange(LinceUniformBuffer ub, unsigned int binding,
+    unsigned int offset, unsigned int size);
+
+/* Returns the alignment in bytes of ranges bound with LinceBindUniformBufferRange */
+unsigned int LinceGetUniformBufferAlignment();
+
+void LinceDeleteUniformBuffer(LinceUniformBuffer ub);
+
+
 #endif // LINCE_BUFFER_H
\ No newline at end of file
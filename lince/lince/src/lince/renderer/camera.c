@@ -4,6 +4,7 @@
 #include <cglm/cam.h>
 #include <cglm/mat4.h>
 #include <cglm/affine.h>
+#include <float.h>
 
 static const LinceCamera default_camera = {
 	.scale = 1.0,
@@ -44,6 +45,7 @@ LinceCamera* LinceCreateCameraFromProj(mat4 proj){
 	memcpy(cam, &default_camera, sizeof(LinceCamera));
 	glm_mat4_copy(proj, cam->proj);
 	glm_mat4_mul(cam->proj, cam->view, cam->view_proj);
+	glm_mat4_inv(cam->view_proj, cam->view_proj_inv);
 	LINCE_PROFILER_END(timer);
 	return cam;
 }
@@ -71,6 +73,24 @@ void LinceUpdateCamera(LinceCamera* cam) {
 	LINCE_PROFILER_END(timer);
 }
 
+void LinceGetCameraViewRect(LinceCamera* cam, vec4 rect){
+	// screen corners in normalised device coordinates
+	static const float ndc[4][2] = {{-1,-1}, {1,-1}, {1,1}, {-1,1}};
+
+	rect[0] = rect[1] =  FLT_MAX;
+	rect[2] = rect[3] = -FLT_MAX;
+	for(int i = 0; i != 4; ++i){
+		vec4 corner = {ndc[i][0], ndc[i][1], 0.0, 1.0};
+		glm_mat4_mulv(cam->view_proj_inv, corner, corner);
+		float x = corner[0] / corner[3];
+		float y = corner[1] / corner[3];
+		rect[0] = glm_min(rect[0], x);
+		rect[1] = glm_min(rect[1], y);
+		rect[2] = glm_max(rect[2], x);
+		rect[3] = glm_max(rect[3], y);
+	}
+}
+
 void LinceResizeCameraView(LinceCamera* cam, float aspect_ratio){
 	cam->aspect_ratio = aspect_ratio;
 	LinceCalculateProjection(
@@ -36,6 +36,12 @@ void LinceSetCameraProj(LinceCamera* cam, mat4 proj);
 and recalculates view-projection matrix */
 void LinceUpdateCamera(LinceCamera* cam);
 
+/*
+Calculates the rectangle of the world the camera sees, from its inverse view-projection matrix.
+Stored as {xmin, ymin, xmax, ymax}. If the camera is rotated, this is the box around the view.
+*/
+void LinceGetCameraViewRect(LinceCamera* cam, vec4 rect);
+
 /* Adapts projection to changes in window dimensions */
 void LinceResizeCameraView(LinceCamera* cam, float aspect_ratio);
 
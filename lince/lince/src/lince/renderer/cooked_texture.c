@@ -0,0 +1,202 @@
+#include "core/profiler.h"
+#include "core/memory.h"
+#include "renderer/cooked_texture.h"
+#include "renderer/block_compression.h"
+#include <stb_image.h>
+
+#ifdef LINCE_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Writes a mip level built by LinceBuildTextureLevels to a file */
+static LinceBool LinceWriteTextureLevel(void* file, uint32_t level,
+	const unsigned char* data, size_t size){
+	LINCE_UNUSED(level);
+	return fwrite(data, size, 1, file) == 1;
+}
+
+LinceBool LinceCookTextureData(
+	const char* path, const unsigned char* data,
+	uint32_t width, uint32_t height, uint32_t flags
+){
+	LINCE_PROFILER_START(timer);
+	LINCE_ASSERT(path && data && width > 0 && height > 0, " Invalid texture data to cook");
+
+	LinceCookedTextureHeader header = {
+		.magic = LINCE_COOKED_TEXTURE_MAGIC,
+		.version = LINCE_COOKED_TEXTURE_VERSION,
+		.width = width,
+		.height = height,
+		.format = LinceGetTextureFlagsFormat(flags),
+		.levels = (flags & LinceTexture_Mipmaps) ? LinceGetMipLevelCount(width, height) : 1,
+		.opaque = LinceIsImageOpaque(data, width, height)
+	};
+
+	FILE* file = fopen(path, "wb");
+	if(!file){
+		LINCE_INFO(" Failed to open '%s' to cook texture", path);
+		return LinceFalse;
+	}
+	LinceBool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+	ok = ok && LinceBuildTextureLevels(data, width, height,
+		(LinceTextureFormat)header.format, header.levels, LinceWriteTextureLevel, file);
+	ok = (fclose(file) == 0) && ok;
+	if(!ok) LINCE_INFO(" Failed to write cooked texture '%s'", path);
+	LINCE_PROFILER_END(timer);
+	return ok;
+}
+
+LinceBool LinceCookTexture(const char* src_path, const char* dst_path, uint32_t flags){
+	LINCE_INFO(" Cooking texture '%s' into '%s'", src_path, dst_path);
+
+	// flipped once here instead of on every load
+	stbi_set_flip_vertically_on_load(flags & LinceTexture_FlipY);
+	int width = 0, height = 0, channels = 0;
+	unsigned char* data = stbi_load(src_path, &width, &height, &channels, 4);
+	if(!data){
+		LINCE_INFO(" Failed to load image '%s'", src_path);
+		return LinceFalse;
+	}
+	LinceBool ok = LinceCookTextureData(dst_path, data, (uint32_t)width, (uint32_t)height, flags);
+	stbi_image_free(data);
+	return ok;
+}
+
+/* Returns the number of bytes of all levels described by a header */
+static size_t LinceGetCookedDataSize(const LinceCookedTextureHeader* header){
+	size_t size = 0;
+	uint32_t w = header->width, h = header->height;
+	for(uint32_t i = 0; i != header->levels; ++i){
+		size += LinceGetTextureLevelSize(header->format, w, h);
+		w = w > 1 ? w / 2 : 1;
+		h = h > 1 ? h / 2 : 1;
+	}
+	return size;
+}
+
+LinceBool LinceMapCookedTexture(const char* path, LinceCookedTexture* cooked){
+	LINCE_PROFILER_START(timer);
+	*cooked = (LinceCookedTexture){0};
+
+#ifdef LINCE_WINDOWS
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE) return LinceFalse;
+	LARGE_INTEGER size;
+	HANDLE mapping = NULL;
+	if(GetFileSizeEx(file, &size) && size.QuadPart > 0){
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	}
+	// the mapping keeps the file open
+	CloseHandle(file);
+	if(!mapping) return LinceFalse;
+	cooked->mapping = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if(!cooked->mapping){
+		CloseHandle(mapping);
+		return LinceFalse;
+	}
+	cooked->handle = mapping;
+	cooked->mapping_size = (size_t)size.QuadPart;
+#else
+	int fd = open(path, O_RDONLY);
+	if(fd < 0) return LinceFalse;
+	struct stat st;
+	void* mapping = MAP_FAILED;
+	if(fstat(fd, &st) == 0 && st.st_size > 0){
+		mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	// the mapping keeps the file open
+	close(fd);
+	if(mapping == MAP_FAILED) return LinceFalse;
+	cooked->mapping = mapping;
+	cooked->mapping_size = (size_t)st.st_size;
+#endif
+
+	// check that the header and all levels are there
+	LinceBool valid = cooked->mapping_size >= sizeof(LinceCookedTextureHeader);
+	if(valid){
+		memcpy(&cooked->header, cooked->mapping, sizeof(LinceCookedTextureHeader));
+		const LinceCookedTextureHeader* h = &cooked->header;
+		valid = memcmp(h->magic, LINCE_COOKED_TEXTURE_MAGIC, 4) == 0 &&
+			h->version == LINCE_COOKED_TEXTURE_VERSION &&
+			h->format < LinceTextureFormat_Count &&
+			h->width > 0 && h->height > 0 &&
+			h->levels > 0 && h->levels <= LinceGetMipLevelCount(h->width, h->height);
+	}
+	if(valid){
+		cooked->data = (const unsigned char*)cooked->mapping + sizeof(LinceCookedTextureHeader);
+		cooked->size = LinceGetCookedDataSize(&cooked->header);
+		valid = cooked->size <= cooked->mapping_size - sizeof(LinceCookedTextureHeader);
+	}
+	if(!valid){
+		LINCE_INFO(" Invalid cooked texture '%s'", path);
+		LinceUnmapCookedTexture(cooked);
+	}
+	LINCE_PROFILER_END(timer);
+	return valid;
+}
+
+void LinceUnmapCookedTexture(LinceCookedTexture* cooked){
+	if(!cooked || !cooked->mapping) return;
+#ifdef LINCE_WINDOWS
+	UnmapViewOfFile(cooked->mapping);
+	CloseHandle(cooked->handle);
+#else
+	munmap(cooked->mapping, cooked->mapping_size);
+#endif
+	*cooked = (LinceCookedTexture){0};
+}
+
+LinceTexture* LinceCreateCookedTexture(const char* name, const LinceCookedTexture* cooked){
+	LINCE_PROFILER_START(timer);
+	const LinceCookedTextureHeader* h = &cooked->header;
+	LinceTextureFormat format = (LinceTextureFormat)h->format;
+
+	// levels the driver cannot sample are decompressed on the CPU
+	unsigned char* pixels = NULL;
+	if(!LinceIsTextureFormatSupported(format)){
+		LINCE_INFO(" Texture format %d not supported, decompressing %s", (int)format, name);
+		pixels = LinceMalloc((size_t)h->width * h->height * 4);
+	}
+	LinceTexture* texture = LinceCreateTextureLevels(
+		name, h->width, h->height, pixels ? LinceTextureFormat_RGBA8 : format, h->levels
+	);
+	texture->opaque = h->opaque ? LinceTrue : LinceFalse;
+
+	// otherwise uploaded straight from the mapped file
+	const unsigned char* data = cooked->data;
+	uint32_t w = h->width, hgt = h->height;
+	for(uint32_t i = 0; i != h->levels; ++i){
+		if(pixels){
+			LinceDecompressImage(format, data, w, hgt, pixels);
+			LinceSetTextureLevelData(texture, i, pixels);
+		} else {
+			LinceSetTextureLevelData(texture, i, data);
+		}
+		data += LinceGetTextureLevelSize(format, w, hgt);
+		w = w > 1 ? w / 2 : 1;
+		hgt = hgt > 1 ? hgt / 2 : 1;
+	}
+	LinceFree(pixels);
+	LINCE_PROFILER_END(timer);
+	return texture;
+}
+
+LinceTexture* LinceLoadCookedTexture(const char* name, const char* path){
+	LINCE_INFO(" Loading cooked texture %s from '%s'", name, path);
+	LinceCookedTexture cooked;
+	LinceBool mapped = LinceMapCookedTexture(path, &cooked);
+	LINCE_ASSERT(mapped, " Failed to load cooked texture '%s'", path);
+	if(!mapped) return NULL;
+
+	LinceTexture* texture = LinceCreateCookedTexture(name, &cooked);
+	LinceUnmapCookedTexture(&cooked);
+	LINCE_INFO(" Loaded %dx%d texture %s with %d levels",
+		(int)texture->width, (int)texture->height, name, (int)texture->levels);
+	return texture;
+}
@@ -0,0 +1,68 @@
+#ifndef LINCE_COOKED_TEXTURE_H
+#define LINCE_COOKED_TEXTURE_H
+
+#include "lince/renderer/texture.h"
+
+#define LINCE_COOKED_TEXTURE_MAGIC "LTEX"
+#define LINCE_COOKED_TEXTURE_VERSION 1
+
+/*
+Header of a cooked texture file.
+It is followed by the data of each mip level from largest to smallest, tightly packed,
+ready to be uploaded without decoding. Rows are stored in upload order, which is
+from the bottom up if the texture was cooked with LinceTexture_FlipY.
+Values are stored in the byte order of the machine that cooked the file.
+*/
+typedef struct LinceCookedTextureHeader {
+	char magic[4];          // LINCE_COOKED_TEXTURE_MAGIC
+	uint32_t version;       // LINCE_COOKED_TEXTURE_VERSION
+	uint32_t width, height; // size of the first level
+	uint32_t format;        // LinceTextureFormat
+	uint32_t levels;        // number of mip levels
+	uint32_t opaque;        // all pixels have full alpha
+	uint32_t reserved;
+} LinceCookedTextureHeader;
+
+/* Cooked texture file mapped into memory */
+typedef struct LinceCookedTexture {
+	LinceCookedTextureHeader header;
+	const unsigned char* data; // data of all levels, following the header
+	size_t size;               // bytes of data
+	void* mapping;             // start of the mapped file
+	size_t mapping_size;       // bytes of the mapped file
+	void* handle;              // file mapping object on Windows
+} LinceCookedTexture;
+
+/*
+Writes RGBA pixel data of size (w,h) to a cooked texture file, with rows in the same order.
+With LinceTexture_Mipmaps, a full mip chain is generated and stored,
+and with LinceTexture_BC1, BC3 or BC7 the levels are compressed.
+Returns false if the file could not be written.
+*/
+LinceBool LinceCookTextureData(
+	const char* path, const unsigned char* data,
+	uint32_t width, uint32_t height, uint32_t flags
+);
+
+/*
+Decodes an image file and writes it to a cooked texture file, meant to be run offline.
+Flags are as in LinceLoadTexture.
+*/
+LinceBool LinceCookTexture(const char* src_path, const char* dst_path, uint32_t flags);
+
+/*
+Maps a cooked texture file into memory and checks its header.
+Returns false if the file is missing or invalid.
+*/
+LinceBool LinceMapCookedTexture(const char* path, LinceCookedTexture* cooked);
+
+/* Unmaps a cooked texture file */
+void LinceUnmapCookedTexture(LinceCookedTexture* cooked);
+
+/* Creates a texture from a mapped cooked texture, uploading from the mapping */
+LinceTexture* LinceCreateCookedTexture(const char* name, const LinceCookedTexture* cooked);
+
+/* Loads a texture from a cooked texture file, see LinceCookTexture */
+LinceTexture* LinceLoadCookedTexture(const char* name, const char* path);
+
+#endif /* LINCE_COOKED_TEXTURE_H */
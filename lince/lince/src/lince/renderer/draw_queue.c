@@ -0,0 +1,53 @@
+#include "renderer/draw_queue.h"
+
+/* Maps a float to an unsigned integer with the same ordering */
+static inline uint32_t LinceSortableFloat(float f){
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    // negative floats are ordered backwards, positive ones need their sign bit set
+    return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+}
+
+uint64_t LinceMakeDrawKey(LinceBool translucent, float z, uint32_t texture){
+    uint64_t depth = LinceSortableFloat(z);
+    texture &= 0xFFFF;
+    if(!translucent){
+        // [0][texture:16][descending z:32]
+        return ((uint64_t)texture << 32) | (uint32_t)~depth;
+    }
+    // [1][ascending z:32][unused:16]
+    return (1ull << 63) | (depth << 16);
+}
+
+void LinceSortDrawKeys(LinceDrawKey* keys, LinceDrawKey* scratch, size_t count){
+    if(count < 2) return;
+
+    LinceDrawKey* src = keys;
+    LinceDrawKey* dst = scratch;
+    size_t offsets[256];
+
+    for(uint32_t shift = 0; shift != 64; shift += 8){
+        // count occurrences of each digit
+        memset(offsets, 0, sizeof(offsets));
+        for(size_t i = 0; i != count; ++i){
+            offsets[(src[i].key >> shift) & 0xFF]++;
+        }
+        // all keys share this digit
+        if(offsets[(src[0].key >> shift) & 0xFF] == count) continue;
+
+        size_t sum = 0;
+        for(uint32_t d = 0; d != 256; ++d){
+            size_t n = offsets[d];
+            offsets[d] = sum;
+            sum += n;
+        }
+        for(size_t i = 0; i != count; ++i){
+            dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+        LinceDrawKey* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if(src != keys) memcpy(keys, src, count * sizeof(LinceDrawKey));
+}
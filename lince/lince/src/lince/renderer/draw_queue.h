@@ -0,0 +1,35 @@
+#ifndef LINCE_DRAW_QUEUE_H
+#define LINCE_DRAW_QUEUE_H
+
+#include "lince/core/core.h"
+
+/*
+Sort key of a queued quad, and its position in the queue.
+Quads are drawn in ascending order of keys, see LinceMakeDrawKey.
+*/
+typedef struct LinceDrawKey {
+    uint64_t key;
+    uint32_t index;
+} LinceDrawKey;
+
+/*
+Builds the sort key of a quad.
+    - `LinceBool translucent`: whether the quad has any pixels that are not fully opaque
+    - `float z`: z-order, higher values are drawn on top
+    - `uint32_t texture`: identifier of the texture, only the lower 16 bits are used
+
+Opaque quads come first, grouped by texture and then from front to back,
+so that hidden pixels fail the depth test early.
+Translucent quads come last, from back to front so that they blend
+over what is behind them. Equal keys keep their order of submission.
+*/
+uint64_t LinceMakeDrawKey(LinceBool translucent, float z, uint32_t texture);
+
+/*
+Sorts keys in ascending order with a stable LSD radix sort.
+`scratch` must have room for `count` keys.
+Digits shared by all keys are skipped.
+*/
+void LinceSortDrawKeys(LinceDrawKey* keys, LinceDrawKey* scratch, size_t count);
+
+#endif /* LINCE_DRAW_QUEUE_H */
@@ -0,0 +1,140 @@
+#include "renderer/gpu_timer.h"
+#include "core/profiler.h"
+
+#include <glad/glad.h>
+#include <string.h>
+
+/* Scope recorded in a frame */
+typedef struct LinceGPUTimerScope {
+	const char* name;
+	uint32_t depth; // number of enclosing scopes
+	LinceBool ended;
+} LinceGPUTimerScope;
+
+/* Queries issued in one frame */
+typedef struct LinceGPUTimerFrame {
+	unsigned int queries[LINCE_GPU_TIMER_MAX_SCOPES * 2]; // begin and end timestamps of each scope
+	LinceGPUTimerScope scopes[LINCE_GPU_TIMER_MAX_SCOPES];
+	uint32_t count;  // scopes begun
+	int64_t offset;  // profiler ticks minus GPU time, measured when the frame began
+} LinceGPUTimerFrame;
+
+/* Global GPU timer state */
+static struct {
+	LinceBool init;
+	LinceGPUTimerFrame frames[LINCE_GPU_TIMER_FRAMES];
+	uint32_t current; // frame whose queries are being issued
+	uint32_t depth;   // scopes open in the current frame
+	float frame_ms;
+	uint64_t dropped;
+} gpu_timer = {0};
+
+/* Clears a frame and aligns the GPU clock with the profiler clock */
+static void LinceBeginGPUTimerFrame(LinceGPUTimerFrame* frame){
+	frame->count = 0;
+	GLint64 gpu_now = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpu_now);
+	frame->offset = (int64_t)LinceGetProfilerTicks() - (int64_t)gpu_now;
+}
+
+/* Reads the results of a frame, returns false if they are not ready */
+static LinceBool LinceReadGPUTimerFrame(LinceGPUTimerFrame* frame){
+	for(uint32_t i = 0; i != frame->count; ++i){
+		if(!frame->scopes[i].ended) continue;
+		GLuint available = GL_FALSE;
+		glGetQueryObjectuiv(frame->queries[2*i + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if(!available) return LinceFalse;
+	}
+
+	float frame_ms = 0.0f;
+	for(uint32_t i = 0; i != frame->count; ++i){
+		const LinceGPUTimerScope* scope = &frame->scopes[i];
+		if(!scope->ended) continue;
+		GLuint64 start = 0, end = 0;
+		glGetQueryObjectui64v(frame->queries[2*i], GL_QUERY_RESULT, &start);
+		glGetQueryObjectui64v(frame->queries[2*i + 1], GL_QUERY_RESULT, &end);
+		if(end < start) end = start;
+		if(scope->depth == 0) frame_ms += (float)(end - start) / 1.0e6f;
+		LinceRecordGPUProfileEvent(scope->name,
+			(uint64_t)((int64_t)start + frame->offset),
+			(uint64_t)((int64_t)end + frame->offset),
+			scope->depth
+		);
+	}
+	gpu_timer.frame_ms = frame_ms;
+	return LinceTrue;
+}
+
+LinceBool LinceIsGPUTimerSupported(void){
+	if(!GLAD_GL_VERSION_3_3) return LinceFalse;
+	// implementations may report zero bits, meaning timestamps are not available
+	GLint bits = 0;
+	glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+	return bits > 0;
+}
+
+void LinceInitGPUTimer(void){
+	if(gpu_timer.init) return;
+	if(!LinceIsGPUTimerSupported()){
+		LINCE_INFO("GPU timer queries not supported");
+		return;
+	}
+	memset(&gpu_timer, 0, sizeof(gpu_timer));
+	for(uint32_t i = 0; i != LINCE_GPU_TIMER_FRAMES; ++i){
+		glGenQueries(LINCE_GPU_TIMER_MAX_SCOPES * 2, gpu_timer.frames[i].queries);
+	}
+	LinceBeginGPUTimerFrame(&gpu_timer.frames[0]);
+	gpu_timer.init = LinceTrue;
+}
+
+void LinceTerminateGPUTimer(void){
+	if(!gpu_timer.init) return;
+	for(uint32_t i = 0; i != LINCE_GPU_TIMER_FRAMES; ++i){
+		glDeleteQueries(LINCE_GPU_TIMER_MAX_SCOPES * 2, gpu_timer.frames[i].queries);
+	}
+	gpu_timer.init = LinceFalse;
+}
+
+LinceGPUScope LinceBeginGPUScope(const char* name){
+	if(!gpu_timer.init) return (LinceGPUScope){.index = UINT32_MAX};
+	LinceGPUTimerFrame* frame = &gpu_timer.frames[gpu_timer.current];
+	if(frame->count == LINCE_GPU_TIMER_MAX_SCOPES) return (LinceGPUScope){.index = UINT32_MAX};
+
+	uint32_t index = frame->count++;
+	frame->scopes[index] = (LinceGPUTimerScope){.name = name, .depth = gpu_timer.depth};
+	gpu_timer.depth++;
+	glQueryCounter(frame->queries[2*index], GL_TIMESTAMP);
+	return (LinceGPUScope){.index = index};
+}
+
+void LinceEndGPUScope(LinceGPUScope scope){
+	if(!gpu_timer.init || scope.index == UINT32_MAX) return;
+	LinceGPUTimerFrame* frame = &gpu_timer.frames[gpu_timer.current];
+	if(scope.index >= frame->count) return; // opened in an earlier frame
+
+	// restoring the depth keeps it right even if an inner scope was never ended
+	gpu_timer.depth = frame->scopes[scope.index].depth;
+	frame->scopes[scope.index].ended = LinceTrue;
+	glQueryCounter(frame->queries[2*scope.index + 1], GL_TIMESTAMP);
+}
+
+void LinceEndGPUTimerFrame(void){
+	if(!gpu_timer.init) return;
+	LINCE_PROFILER_START(timer);
+	gpu_timer.current = (gpu_timer.current + 1) % LINCE_GPU_TIMER_FRAMES;
+	gpu_timer.depth = 0;
+
+	// the oldest frame is the next one to reuse its queries
+	LinceGPUTimerFrame* frame = &gpu_timer.frames[gpu_timer.current];
+	if(!LinceReadGPUTimerFrame(frame)) gpu_timer.dropped++;
+	LinceBeginGPUTimerFrame(frame);
+	LINCE_PROFILER_END(timer);
+}
+
+float LinceGetGPUFrameTime(void){
+	return gpu_timer.frame_ms;
+}
+
+uint64_t LinceGetGPUTimerDroppedFrames(void){
+	return gpu_timer.dropped;
+}
@@ -0,0 +1,56 @@
+#ifndef LINCE_GPU_TIMER_H
+#define LINCE_GPU_TIMER_H
+
+#include "lince/core/core.h"
+
+/*
+Number of frames of queries in flight. Results of a frame are read
+this many frames later, when the GPU has most likely finished it.
+*/
+#define LINCE_GPU_TIMER_FRAMES 2
+
+/* Max number of GPU scopes recorded in one frame */
+#define LINCE_GPU_TIMER_MAX_SCOPES 128
+
+/* Open GPU scope, returned by LinceBeginGPUScope */
+typedef struct LinceGPUScope {
+	uint32_t index; // slot of the scope in the frame, UINT32_MAX if it was not recorded
+} LinceGPUScope;
+
+/* Returns true if the OpenGL context supports timestamp queries */
+LinceBool LinceIsGPUTimerSupported(void);
+
+/*
+Creates the queries used to time scopes on the GPU.
+Does nothing if timestamp queries are not supported,
+in which case scopes are not recorded.
+*/
+void LinceInitGPUTimer(void);
+
+/* Deletes the queries of the GPU timer */
+void LinceTerminateGPUTimer(void);
+
+/*
+Opens a scope timed on the GPU, e.g. around a pass of the renderer.
+The name must be a string that lives until the profiler is stopped, such as a literal.
+Scopes may be nested, and must be opened and closed within the same frame.
+*/
+LinceGPUScope LinceBeginGPUScope(const char* name);
+
+/* Closes a scope timed on the GPU */
+void LinceEndGPUScope(LinceGPUScope scope);
+
+/*
+Ends the frame of GPU scopes and starts the next one.
+The scopes of the frame issued LINCE_GPU_TIMER_FRAMES ago are read if their results are available,
+and sent to the profiler when it is running. Otherwise they are discarded, so that it never waits on the GPU.
+*/
+void LinceEndGPUTimerFrame(void);
+
+/* Returns the time in milliseconds the GPU spent on the outermost scopes of the last frame read */
+float LinceGetGPUFrameTime(void);
+
+/* Returns the number of frames of GPU scopes discarded because their results were not ready */
+uint64_t LinceGetGPUTimerDroppedFrames(void);
+
+#endif /* LINCE_GPU_TIMER_H */
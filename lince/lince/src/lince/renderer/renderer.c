@@ -1,11 +1,18 @@
 #include "core/profiler.h"
 #include "renderer/renderer.h"
 #include "renderer/camera.h"
+#include "renderer/transform.h"
+#include "renderer/draw_queue.h"
+#include "renderer/gpu_timer.h"
+#include "core/memory.h"
+#include "core/app.h"
 #include <glad/glad.h>
 #include "cglm/types.h"
 #include "cglm/vec4.h"
 #include "cglm/affine.h"
 #include "cglm/io.h"
+#include <math.h>
+#include <string.h>
 
 
 #define QUAD_VERTEX_COUNT 4 // number of vertices in one quad
@@ -14,38 +21,104 @@
 #define MAX_QUADS 20000    // Maximum number of quads in a single vertex batch
 #define MAX_VERTICES (MAX_QUADS * QUAD_VERTEX_COUNT) // max number of vertices in a batch
 #define MAX_INDICES (MAX_QUADS * QUAD_INDEX_COUNT)   // max number of indices in a batch
-#define MAX_TEXTURE_SLOTS 32   // max number of textures the GPU can bind simultaneously
+#define MAX_TEXTURE_SLOTS 28      // max number of 2D textures bound in a batch
+#define MAX_TEXTURE_POOL_SLOTS 4  // max number of texture pools bound in a batch, after the 2D textures
+// 2D textures and pools together take up the 32 texture units the GPU can bind simultaneously
 
 
-const char default_fragment_source[] =
-	"#version 450 core\n"
-	"layout(location = 0) out vec4 color;\n"
-	"in vec4 vColor;\n"
-	"in vec2 vTexCoord;\n"
-	"in float vTextureID;\n"
-	"uniform sampler2D uTextureSlots[32];\n"
-	"void main(){\n"
-	"	color = texture(uTextureSlots[int(vTextureID)], vTexCoord) * vColor;\n"
-	"	if (color.a == 0.0) discard;\n"
-	"	// temporary solution for full transparency, not translucency.\n"
-	"}\n";
+/*
+Samples the texture of a quad with a constant index for each slot.
+Sampler arrays may only be indexed with dynamically uniform values in GLSL 4.50,
+and the texture ID varies between the quads of a draw call.
+*/
+#define LINCE_SAMPLE_SLOT(i) "		case " #i "u: color = texture(uTextureSlots[" #i "], vTexCoord); break;\n"
+#define LINCE_SAMPLE_SLOTS4(a, b, c, d) \
+	LINCE_SAMPLE_SLOT(a) LINCE_SAMPLE_SLOT(b) LINCE_SAMPLE_SLOT(c) LINCE_SAMPLE_SLOT(d)
+#define LINCE_SAMPLE_POOL(i) "		case " #i "u: color = texture(uTexturePools[" #i " - 28], vec3(vTexCoord, vLayer)); break;\n"
+
+/* Fragment shader source, with extra statements at the end of main() */
+#define LINCE_FRAGMENT_SOURCE(extra) \
+	"#version 450 core\n" \
+	"layout(location = 0) out vec4 color;\n" \
+	"in vec4 vColor;\n" \
+	"in vec2 vTexCoord;\n" \
+	"flat in uint vTextureID;\n" \
+	"flat in uint vLayer;\n" \
+	"uniform sampler2D uTextureSlots[28];\n" \
+	"uniform sampler2DArray uTexturePools[4];\n" \
+	"void main(){\n" \
+	"	switch(vTextureID){\n" \
+	LINCE_SAMPLE_SLOTS4(0, 1, 2, 3)     LINCE_SAMPLE_SLOTS4(4, 5, 6, 7) \
+	LINCE_SAMPLE_SLOTS4(8, 9, 10, 11)   LINCE_SAMPLE_SLOTS4(12, 13, 14, 15) \
+	LINCE_SAMPLE_SLOTS4(16, 17, 18, 19) LINCE_SAMPLE_SLOTS4(20, 21, 22, 23) \
+	LINCE_SAMPLE_SLOTS4(24, 25, 26, 27) \
+	LINCE_SAMPLE_POOL(28) LINCE_SAMPLE_POOL(29) LINCE_SAMPLE_POOL(30) LINCE_SAMPLE_POOL(31) \
+	"		default: color = vec4(1.0);\n" \
+	"	}\n" \
+	"	color *= vColor;\n" \
+	extra \
+	"}\n"
+
+/* Quad meshes are drawn unsorted, so transparent pixels must not write depth */
+#define LINCE_MESH_FRAGMENT_EXTRA "	if (color.a == 0.0) discard;\n"
+
+/*
+Queued quads are sorted so that translucent ones are drawn last without writing depth,
+which lets opaque quads keep early depth testing.
+*/
+const char default_fragment_source[] = LINCE_FRAGMENT_SOURCE("");
+const char mesh_fragment_source[] = LINCE_FRAGMENT_SOURCE(LINCE_MESH_FRAGMENT_EXTRA);
 
 const char default_vertex_source[] = 
 	"#version 450 core\n"
 	"layout (location = 0) in vec3 aPos;\n"
 	"layout (location = 1) in vec2 aTexCoord;\n"
 	"layout (location = 2) in vec4 aColor;\n"
-	"layout (location = 3) in float aTextureID;\n"
+	"layout (location = 3) in uint aTextureID;\n"
+	"layout (location = 4) in uint aLayer;\n"
 	"out vec4 vColor;\n"
 	"out vec2 vTexCoord;\n"
-	"out float vTextureID;\n"
-	"uniform mat4 u_view_proj = mat4(1.0);\n"
+	"flat out uint vTextureID;\n"
+	"flat out uint vLayer;\n"
+	LINCE_SCENE_UNIFORM_GLSL
 	"uniform mat4 u_transform = mat4(1.0);\n"
 	"void main(){\n"
 	"   gl_Position = u_view_proj * u_transform * vec4(aPos, 1.0);\n"
 	"   vColor = aColor;\n"
 	"   vTexCoord = aTexCoord;\n"
 	"   vTextureID = aTextureID;\n"
+	"   vLayer = aLayer;\n"
+	"}\n";
+
+/* Expands one quad instance into the four corners given by the index buffer */
+const char instanced_vertex_source[] = 
+	"#version 450 core\n"
+	"layout (location = 0) in vec3 aPos;\n"
+	"layout (location = 1) in vec2 aSize;\n"
+	"layout (location = 2) in float aRotation;\n"
+	"layout (location = 3) in vec4 aTexRect;\n"
+	"layout (location = 4) in vec4 aColor;\n"
+	"layout (location = 5) in uint aTextureID;\n"
+	"layout (location = 6) in uint aLayer;\n"
+	"out vec4 vColor;\n"
+	"out vec2 vTexCoord;\n"
+	"flat out uint vTextureID;\n"
+	"flat out uint vLayer;\n"
+	LINCE_SCENE_UNIFORM_GLSL
+	"uniform mat4 u_transform = mat4(1.0);\n"
+	"const vec2 corners[4] = vec2[4](\n"
+	"   vec2(-0.5,-0.5), vec2(0.5,-0.5), vec2(0.5,0.5), vec2(-0.5,0.5)\n"
+	");\n"
+	"void main(){\n"
+	"   vec2 corner = corners[gl_VertexID];\n"
+	"   vec2 local = corner * aSize;\n"
+	"   float r = radians(aRotation);\n" // clockwise
+	"   vec2 pos = vec2(local.x*cos(r) + local.y*sin(r), -local.x*sin(r) + local.y*cos(r));\n"
+	"   gl_Position = u_view_proj * u_transform * vec4(pos + aPos.xy, aPos.z, 1.0);\n"
+	"   vColor = aColor;\n"
+	"   vTexCoord = mix(aTexRect.xy, aTexRect.zw, corner + 0.5);\n"
+	"   vTextureID = aTextureID;\n"
+	"   vLayer = aLayer;\n"
 	"}\n";
 
 
@@ -56,44 +129,132 @@ float LinceYSortedZ(float y, vec2 ylim, vec2 zlim){
     return z;
 }
 
-// stores information of one vertex
+// stores information of one vertex (28 bytes)
 // ensure this struct has no padding
 typedef struct LinceQuadVertex {
-	float x, y, z; 	   // position
-	float s, t; 	   // texture coordinates
-	float color[4];	   // rgba color
-	float texture_id;  // binding slot for the texture
+	float x, y, z; 	     // position
+	float s, t; 	     // texture coordinates
+	uint8_t color[4];	 // rgba color, normalised to [0,1] on the GPU
+	uint16_t texture_id; // binding slot for the texture
+	uint16_t layer;      // layer of the texture if it is in a pool
 } LinceQuadVertex;
 
+// stores information of one quad drawn with instancing (48 bytes)
+// ensure this struct has no padding
+typedef struct LinceQuadInstance {
+	float x, y, z;       // position
+	float w, h;          // size
+	float rotation;      // clockwise rotation in degrees
+	float tex_rect[4];   // texture coordinates of lower left and upper right corners
+	uint8_t color[4];    // rgba color, normalised to [0,1] on the GPU
+	uint16_t texture_id; // binding slot for the texture
+	uint16_t layer;      // layer of the texture if it is in a pool
+} LinceQuadInstance;
+
+// quad submitted for drawing at the end of the scene
+typedef struct LinceQueuedQuad {
+	float x, y, w, h;      // position and size
+	float z;               // z-order
+	float rotation;        // clockwise rotation in degrees
+	float xs[4], ys[4];    // positions of the corners, if transformed
+	float coords[8];       // texture coordinates
+	uint8_t color[4];      // rgba color
+	LinceBool transformed; // corners have been calculated
+	LinceTexture* texture; // NULL for the white texture
+} LinceQueuedQuad;
+
+// quads recorded for drawing at the end of the scene
+struct LinceQuadBuffer {
+	LinceQueuedQuad* quads;
+	LinceDrawKey* keys; // sort keys, indexing `quads`
+	size_t count;       // number of quads
+	size_t capacity;    // max number of quads before reallocation
+	size_t culled;      // number of quads culled while recording
+};
+
 typedef struct LinceRendererState {
 	LinceShader* shader;
+	LinceShader* mesh_shader; // discards transparent pixels, used by quad meshes
 	LinceTexture* white_texture;
+
+	// Per-scene uniforms
+	LinceUniformBuffer scene_ub; // ring of LINCE_SCENE_UNIFORM_SLOTS copies of LinceSceneUniforms
+	unsigned int scene_stride;   // bytes between copies, aligned for binding
+	unsigned int scene_slot;     // next copy to write
+	int mesh_transform_id;       // ID of u_transform in the mesh shader
 	
 	LinceVertexArray* va;
     LinceVertexBuffer vb;
     LinceIndexBuffer ib;
+	LinceStreamBuffer* stream; // persistently mapped vertex ring, NULL if unsupported
 
 	// Batch rendering
 	unsigned int quad_count;       // number of quads in the batch
-	LinceQuadVertex* vertex_batch; // collection of vertices to render
+	LinceQuadVertex* vertex_batch; // collection of vertices to render,
+	                               // points to mapped GPU memory when streaming
 	unsigned int* index_batch;     // collection of indices to render
 
 	unsigned int texture_slot_count;
 	LinceTexture* texture_slots[MAX_TEXTURE_SLOTS];
+	unsigned int pool_slot_count;
+	LinceTexturePool* pool_slots[MAX_TEXTURE_POOL_SLOTS];
+
+	// Instanced rendering
+	LinceBool instancing;              // quads are batched as instances instead of vertices
+	LinceShader* instance_shader;
+	LinceVertexArray* instance_va;
+	LinceVertexBuffer instance_vb;
+	LinceStreamBuffer* instance_stream; // persistently mapped instance ring, NULL if unsupported
+	LinceQuadInstance* instance_batch;  // collection of instances to render
+
+	// Statistics
+	LinceRendererStats stats;      // counters of the scene, reset by LinceBeginScene
+	LinceRendererStats frame;      // counters of the finished scenes of the frame
+	LinceRendererStats last_frame; // counters and frame times of the last frame
+	float frame_times[LINCE_FRAME_TIME_SAMPLES]; // ring of the last frame times in ms
+	size_t frame_count;            // frames recorded by LinceEndRendererFrame
+
+	// Culling
+	LinceBool culling;   // skip quads outside the view of the camera
+	vec4 view_rect;      // world rectangle seen by the scene camera {xmin, ymin, xmax, ymax}
+
+	// Deferred drawing
+	LinceQuadBuffer queue;       // quads submitted since the queue was last drawn
+	LinceDrawKey* queue_scratch; // buffer for sorting keys
+	size_t scratch_capacity;     // max number of keys in the scratch buffer
 
 } LinceRendererState;
 
 /* Global rendering state */
 static LinceRendererState renderer_state = {0};
 
-/* quad of size 1x1 centred on 0,0 */
-static const LinceQuadVertex quad_vertices[4] = {
-	{.x=-0.5f, .y=-0.5f, .z=0, .s=0.0, .t=0.0, .color={0.0, 0.0, 0.0, 1.0}, .texture_id=0.0},
-	{.x= 0.5f, .y=-0.5f, .z=0, .s=1.0, .t=0.0, .color={0.0, 0.0, 0.0, 1.0}, .texture_id=0.0},
-	{.x= 0.5f, .y= 0.5f, .z=0, .s=1.0, .t=1.0, .color={0.0, 0.0, 0.0, 1.0}, .texture_id=0.0},
-	{.x=-0.5f, .y= 0.5f, .z=0, .s=0.0, .t=1.0, .color={0.0, 0.0, 0.0, 1.0}, .texture_id=0.0},
+/* Returns the number of bytes a quad takes up in the active batch */
+static size_t LinceGetQuadBatchBytes(){
+	if(renderer_state.instancing) return sizeof(LinceQuadInstance);
+	return sizeof(LinceQuadVertex) * QUAD_VERTEX_COUNT;
+}
+
+/* Points the active batch to the current segment of its ring buffer */
+static void LinceMapQuadBatch(){
+	if(renderer_state.instancing && renderer_state.instance_stream){
+		renderer_state.instance_batch = LinceMapStreamSegment(renderer_state.instance_stream);
+	} else if(!renderer_state.instancing && renderer_state.stream){
+		renderer_state.vertex_batch = LinceMapStreamSegment(renderer_state.stream);
+	}
+}
+
+/* Layout of LinceQuadVertex */
+static LinceBufferElement quad_vertex_layout[] = {
+	{LinceBufferType_Float3,     "aPos",       0,0,0,0,0},
+	{LinceBufferType_Float2,     "aTexCoord",  0,0,0,0,0},
+	{LinceBufferType_UByte4Norm, "aColor",     0,0,0,0,0},
+	{LinceBufferType_UShort,     "aTextureID", 0,0,0,0,0},
+	{LinceBufferType_UShort,     "aLayer",     0,0,0,0,0}
 };
+
 static const unsigned int quad_indices[] = {0,1,2,2,3,0};
+/* texture coordinates of the corners of a quad, see LinceTransformQuad */
+static const float quad_tex_coords[] = {0,0, 1,0, 1,1, 0,1};
 
 
 void LinceDrawIndexed(
@@ -104,6 +265,7 @@ void LinceDrawIndexed(
 	LinceBindIndexBuffer(ib);
 	LinceBindVertexArray(va);
 	glDrawElements(GL_TRIANGLES, ib.count, GL_UNSIGNED_INT, 0);
+	renderer_state.stats.draw_calls++;
 	LINCE_PROFILER_END(timer);
 }
 
@@ -136,21 +298,23 @@ void LinceInitRenderer() {
 	LinceEnableDepthTest();
 
 	// Initialise geometry
-	renderer_state.vertex_batch = calloc(MAX_VERTICES, sizeof(LinceQuadVertex));
 	renderer_state.index_batch = calloc(MAX_INDICES, sizeof(unsigned int));
-	LINCE_ASSERT_ALLOC(renderer_state.vertex_batch, sizeof(LinceQuadVertex) * MAX_VERTICES);
 	LINCE_ASSERT_ALLOC(renderer_state.index_batch, sizeof(unsigned int) * MAX_INDICES);
-	
-	renderer_state.vb = LinceCreateVertexBuffer(
-		renderer_state.vertex_batch,
-		MAX_VERTICES * sizeof(LinceQuadVertex)
-	);
-	LinceBufferElement layout[] = {
-        {LinceBufferType_Float3, "aPos",       0,0,0,0},
-        {LinceBufferType_Float2, "aTexCoord",  0,0,0,0},
-        {LinceBufferType_Float4, "aColor",     0,0,0,0},
-		{LinceBufferType_Float,  "aTextureID", 0,0,0,0}
-    };
+
+	if(LinceIsStreamBufferSupported()){
+		// quads are written straight into a ring of mapped segments
+		renderer_state.stream = LinceCreateStreamBuffer(
+			MAX_VERTICES * sizeof(LinceQuadVertex)
+		);
+		renderer_state.vb = renderer_state.stream->vb;
+		renderer_state.vertex_batch = LinceMapStreamSegment(renderer_state.stream);
+	} else {
+		renderer_state.vertex_batch = calloc(MAX_VERTICES, sizeof(LinceQuadVertex));
+		LINCE_ASSERT_ALLOC(renderer_state.vertex_batch, sizeof(LinceQuadVertex) * MAX_VERTICES);
+		renderer_state.vb = LinceCreateVertexBuffer(
+			NULL, MAX_VERTICES * sizeof(LinceQuadVertex)
+		);
+	}
 
 	// Generate indices for all quads in a full batch
 	unsigned int offset = 0;
@@ -165,11 +329,11 @@ void LinceInitRenderer() {
 	renderer_state.va = LinceCreateVertexArray(renderer_state.ib);
 	LinceBindVertexArray(renderer_state.va);
     LinceBindIndexBuffer(renderer_state.ib);
-	unsigned int elem_count = sizeof(layout) / sizeof(LinceBufferElement);
+	unsigned int elem_count = sizeof(quad_vertex_layout) / sizeof(LinceBufferElement);
     LinceAddVertexArrayAttributes(
 		renderer_state.va,
 		renderer_state.vb,
-		layout, elem_count
+		quad_vertex_layout, elem_count
 	);
 	
 	// create default white texture
@@ -188,27 +352,116 @@ void LinceInitRenderer() {
 	int samplers[MAX_TEXTURE_SLOTS] = { 0 };
 	for (int i = 0; i != MAX_TEXTURE_SLOTS; ++i) samplers[i] = i;
 	LinceSetShaderUniformIntN(renderer_state.shader, "uTextureSlots", samplers, MAX_TEXTURE_SLOTS);
+	int pool_samplers[MAX_TEXTURE_POOL_SLOTS] = { 0 };
+	for (int i = 0; i != MAX_TEXTURE_POOL_SLOTS; ++i) pool_samplers[i] = MAX_TEXTURE_SLOTS + i;
+	LinceSetShaderUniformIntN(renderer_state.shader, "uTexturePools", pool_samplers, MAX_TEXTURE_POOL_SLOTS);
+
+	renderer_state.mesh_shader = LinceCreateShaderFromSrc(
+		"RendererMeshShader",
+		default_vertex_source,
+		mesh_fragment_source
+	);
+	LinceBindShader(renderer_state.mesh_shader);
+	LinceSetShaderUniformIntN(renderer_state.mesh_shader, "uTextureSlots", samplers, MAX_TEXTURE_SLOTS);
+	LinceSetShaderUniformIntN(renderer_state.mesh_shader, "uTexturePools", pool_samplers, MAX_TEXTURE_POOL_SLOTS);
+	renderer_state.mesh_transform_id = LinceGetShaderUniformID(renderer_state.mesh_shader, "u_transform");
+
+	// Instanced geometry: the first quad of the index buffer is reused for every instance
+	if(LinceIsStreamBufferSupported()){
+		renderer_state.instance_stream = LinceCreateStreamBuffer(
+			MAX_QUADS * sizeof(LinceQuadInstance)
+		);
+		renderer_state.instance_vb = renderer_state.instance_stream->vb;
+	} else {
+		renderer_state.instance_batch = calloc(MAX_QUADS, sizeof(LinceQuadInstance));
+		LINCE_ASSERT_ALLOC(renderer_state.instance_batch, sizeof(LinceQuadInstance) * MAX_QUADS);
+		renderer_state.instance_vb = LinceCreateVertexBuffer(
+			NULL, MAX_QUADS * sizeof(LinceQuadInstance)
+		);
+	}
+	LinceBufferElement instance_layout[] = {
+        {LinceBufferType_Float3,     "aPos",       0,0,0,0,0},
+        {LinceBufferType_Float2,     "aSize",      0,0,0,0,0},
+        {LinceBufferType_Float,      "aRotation",  0,0,0,0,0},
+        {LinceBufferType_Float4,     "aTexRect",   0,0,0,0,0},
+        {LinceBufferType_UByte4Norm, "aColor",     0,0,0,0,0},
+		{LinceBufferType_UShort,     "aTextureID", 0,0,0,0,0},
+		{LinceBufferType_UShort,     "aLayer",     0,0,0,0,0}
+    };
+	renderer_state.instance_va = LinceCreateVertexArray(renderer_state.ib);
+	LinceBindIndexBuffer(renderer_state.ib);
+	elem_count = sizeof(instance_layout) / sizeof(LinceBufferElement);
+	LinceAddVertexArrayInstanceAttributes(
+		renderer_state.instance_va,
+		renderer_state.instance_vb,
+		instance_layout, elem_count
+	);
+
+	renderer_state.instance_shader = LinceCreateShaderFromSrc(
+		"RendererInstancedShader",
+		instanced_vertex_source,
+		default_fragment_source
+	);
+	LinceBindShader(renderer_state.instance_shader);
+	LinceSetShaderUniformIntN(renderer_state.instance_shader, "uTextureSlots", samplers, MAX_TEXTURE_SLOTS);
+	LinceSetShaderUniformIntN(renderer_state.instance_shader, "uTexturePools", pool_samplers, MAX_TEXTURE_POOL_SLOTS);
+	LinceBindShader(renderer_state.shader);
+
+	// Per-scene uniforms, read by every shader that declares the scene block
+	unsigned int alignment = LinceGetUniformBufferAlignment();
+	renderer_state.scene_stride = (unsigned int)(
+		(sizeof(LinceSceneUniforms) + alignment - 1) / alignment * alignment
+	);
+	renderer_state.scene_ub = LinceCreateUniformBuffer(
+		NULL, renderer_state.scene_stride * LINCE_SCENE_UNIFORM_SLOTS
+	);
+	renderer_state.scene_slot = 0;
 
 	LINCE_PROFILER_END(timer);
 }
 
 void LinceTerminateRenderer() {
 	renderer_state.quad_count = 0;
-	if(renderer_state.vertex_batch){
+	if(renderer_state.vertex_batch && !renderer_state.stream){
 		free(renderer_state.vertex_batch);
-		renderer_state.vertex_batch = NULL;
 	}
+	renderer_state.vertex_batch = NULL;
 	if(renderer_state.index_batch){
 		free(renderer_state.index_batch);
 		renderer_state.index_batch = NULL;
 	}
 
 	LinceDeleteShader(renderer_state.shader);
+	LinceDeleteShader(renderer_state.mesh_shader);
+	LinceDeleteShader(renderer_state.instance_shader);
+	LinceDeleteUniformBuffer(renderer_state.scene_ub);
+	renderer_state.scene_ub = 0;
+
+	LinceFree(renderer_state.queue.quads);
+	LinceFree(renderer_state.queue.keys);
+	LinceFree(renderer_state.queue_scratch);
+	renderer_state.queue = (LinceQuadBuffer){0};
+	renderer_state.scratch_capacity = 0;
     LinceDeleteTexture(renderer_state.white_texture);
 
-	LinceDeleteVertexBuffer(renderer_state.vb);
+	if(renderer_state.instance_stream){
+		LinceDeleteStreamBuffer(renderer_state.instance_stream);
+		renderer_state.instance_stream = NULL;
+	} else {
+		free(renderer_state.instance_batch);
+		LinceDeleteVertexBuffer(renderer_state.instance_vb);
+	}
+	renderer_state.instance_batch = NULL;
+
+	if(renderer_state.stream){
+		LinceDeleteStreamBuffer(renderer_state.stream);
+		renderer_state.stream = NULL;
+	} else {
+		LinceDeleteVertexBuffer(renderer_state.vb);
+	}
     LinceDeleteIndexBuffer(renderer_state.ib);
     LinceDeleteVertexArray(renderer_state.va);
+    LinceDeleteVertexArray(renderer_state.instance_va);
 }
 
 void LinceBeginScene(LinceCamera* cam) {
@@ -224,110 +477,694 @@ void LinceBeginScene(LinceCamera* cam) {
 	LinceEnableDepthTest();
 
 	/* Update camera */
-	LinceSetShaderUniformMat4(renderer_state.shader, "u_view_proj", cam->view_proj);
+	LinceSceneUniforms scene = {0};
+	memcpy(scene.view_proj, cam->view_proj, sizeof(scene.view_proj));
+	memcpy(scene.view_proj_inv, cam->view_proj_inv, sizeof(scene.view_proj_inv));
+	LinceApp* app = LinceGetAppState();
+	if(app){
+		scene.screen_size[0] = (float)app->screen_width;
+		scene.screen_size[1] = (float)app->screen_height;
+		scene.time = app->time_ms;
+		scene.dt = app->dt;
+	}
+	unsigned int offset = renderer_state.scene_slot * renderer_state.scene_stride;
+	LinceSetUniformBufferData(renderer_state.scene_ub, offset, &scene, sizeof(scene));
+	LinceBindUniformBufferRange(renderer_state.scene_ub, LINCE_SCENE_UNIFORM_BINDING,
+		offset, sizeof(scene));
+	renderer_state.scene_slot = (renderer_state.scene_slot + 1) % LINCE_SCENE_UNIFORM_SLOTS;
 	
 	/* Reset batch */
 	renderer_state.quad_count = 0;
 	renderer_state.texture_slots[0] = renderer_state.white_texture;
 	renderer_state.texture_slot_count = 1;
+	renderer_state.pool_slot_count = 0;
+	renderer_state.stats = (LinceRendererStats){0};
+	renderer_state.queue.count = 0;
+	renderer_state.queue.culled = 0;
+	LinceGetCameraViewRect(cam, renderer_state.view_rect);
+	LinceMapQuadBatch();
 
-	size_t size = (MAX_VERTICES * sizeof(LinceQuadVertex));
-	memset(renderer_state.vertex_batch, 0, size);
+	// No need to clear the vertex batch:
+	// only the vertices of submitted quads are uploaded and drawn.
 
 	LINCE_PROFILER_END(timer);
 }
 
 void LinceFlushScene(){
 	LINCE_PROFILER_START(timer);
+	LinceGPUScope gpu_scope = LinceBeginGPUScope("LinceFlushScene");
 
 	for (uint32_t i = 0; i != renderer_state.texture_slot_count; ++i){
 		LinceBindTexture(renderer_state.texture_slots[i], i);
 	}
-	LinceDrawIndexed(renderer_state.shader, renderer_state.va, renderer_state.ib);
+	for (uint32_t i = 0; i != renderer_state.pool_slot_count; ++i){
+		LinceBindTexturePool(renderer_state.pool_slots[i], MAX_TEXTURE_SLOTS + i);
+	}
+	renderer_state.stats.texture_binds += renderer_state.texture_slot_count + renderer_state.pool_slot_count;
+	renderer_state.stats.batches++;
+	renderer_state.stats.draw_calls++;
+	if(renderer_state.instancing){
+		// instances of the current ring segment start after those of previous segments
+		unsigned int base_instance = 0;
+		if(renderer_state.instance_stream){
+			base_instance = renderer_state.instance_stream->segment * MAX_QUADS;
+		}
+		LinceBindShader(renderer_state.instance_shader);
+		LinceBindVertexArray(renderer_state.instance_va);
+		LinceBindIndexBuffer(renderer_state.ib);
+		glDrawElementsInstancedBaseInstance(GL_TRIANGLES,
+			QUAD_INDEX_COUNT, GL_UNSIGNED_INT, 0,
+			renderer_state.quad_count, base_instance
+		);
+		LinceEndGPUScope(gpu_scope);
+		LINCE_PROFILER_END(timer);
+		return;
+	}
+
+	// vertices of the current ring segment start after those of previous segments
+	int base_vertex = 0;
+	if(renderer_state.stream){
+		base_vertex = (int)(renderer_state.stream->segment * MAX_VERTICES);
+	}
+
+	// draw only the indices of the filled part of the batch
+	LinceBindShader(renderer_state.shader);
+	LinceBindIndexBuffer(renderer_state.ib);
+	LinceBindVertexArray(renderer_state.va);
+	glDrawElementsBaseVertex(GL_TRIANGLES,
+		renderer_state.quad_count * QUAD_INDEX_COUNT,
+		GL_UNSIGNED_INT, 0, base_vertex
+	);
 	
+	LinceEndGPUScope(gpu_scope);
 	LINCE_PROFILER_END(timer);
 }
 
-void LinceEndScene() {
-	// uint32_t size = (uint32_t)(renderer_state.quad_count * sizeof(LinceQuadVertex) * QUAD_VERTEX_COUNT);
-	uint32_t size = (uint32_t)(MAX_VERTICES * sizeof(LinceQuadVertex));
-	LinceSetVertexBufferData(renderer_state.vb, renderer_state.vertex_batch, size);
+/* Uploads and draws the quads in the batch */
+static void LinceFlushBatch() {
+	if(renderer_state.quad_count == 0) return;
+	uint32_t size = (uint32_t)(renderer_state.quad_count * LinceGetQuadBatchBytes());
+	LinceStreamBuffer* stream = renderer_state.instancing ?
+		renderer_state.instance_stream : renderer_state.stream;
+	
+	if(!stream && renderer_state.instancing){
+		LinceSetVertexBufferData(renderer_state.instance_vb, renderer_state.instance_batch, size);
+	} else if(!stream){
+		LinceSetVertexBufferData(renderer_state.vb, renderer_state.vertex_batch, size);
+	}
+	renderer_state.stats.bytes_uploaded += size;
 	LinceFlushScene();
+
+	if(stream){
+		// the next batch goes to the next segment while the GPU reads this one
+		LinceAdvanceStreamSegment(stream);
+		LinceMapQuadBatch();
+	}
+}
+
+static void LinceDrawQueuedQuads();
+
+void LinceEndScene() {
+	LinceDrawQueuedQuads();
+
+	// add the scene to the totals of the frame
+	LinceRendererStats* scene = &renderer_state.stats;
+	LinceRendererStats* frame = &renderer_state.frame;
+	scene->quads_culled += renderer_state.queue.culled;
+	renderer_state.queue.culled = 0;
+	frame->quads_drawn += scene->quads_drawn;
+	frame->quads_culled += scene->quads_culled;
+	frame->batches += scene->batches;
+	frame->draw_calls += scene->draw_calls;
+	frame->texture_binds += scene->texture_binds;
+	frame->bytes_uploaded += scene->bytes_uploaded;
+	frame->scenes++;
+}
+
+/* Compares two floats for qsort */
+static int LinceCompareFloats(const void* a, const void* b){
+	float x = *(const float*)a, y = *(const float*)b;
+	return (x > y) - (x < y);
+}
+
+void LinceEndRendererFrame(float dt){
+	LINCE_PROFILER_START(timer);
+	renderer_state.frame_times[renderer_state.frame_count % LINCE_FRAME_TIME_SAMPLES] = dt;
+	renderer_state.frame_count++;
+
+	LinceRendererStats* stats = &renderer_state.last_frame;
+	*stats = renderer_state.frame;
+	renderer_state.frame = (LinceRendererStats){0};
+
+	size_t n = renderer_state.frame_count < LINCE_FRAME_TIME_SAMPLES ?
+		renderer_state.frame_count : LINCE_FRAME_TIME_SAMPLES;
+	float sorted[LINCE_FRAME_TIME_SAMPLES];
+	memcpy(sorted, renderer_state.frame_times, n * sizeof(float));
+	qsort(sorted, n, sizeof(float), LinceCompareFloats);
+	float sum = 0.0f;
+	for(size_t i = 0; i != n; ++i) sum += sorted[i];
+	stats->frame_ms = dt;
+	stats->frame_min_ms = sorted[0];
+	stats->frame_avg_ms = sum / (float)n;
+	stats->frame_p99_ms = sorted[(n * 99) / 100 < n ? (n * 99) / 100 : n - 1];
+	stats->gpu_ms = LinceGetGPUFrameTime();
+
+	// graphs of the frame statistics in the profiler trace
+	LINCE_PROFILER_COUNTER("batches", stats->batches);
+	LINCE_PROFILER_COUNTER("draw_calls", stats->draw_calls);
+	LINCE_PROFILER_COUNTER("texture_binds", stats->texture_binds);
+	LINCE_PROFILER_END(timer);
+}
+
+LinceRendererStats LinceGetRendererStats(){
+	return renderer_state.last_frame;
+}
+
+size_t LinceGetRendererUploadedBytes(){
+	return renderer_state.stats.bytes_uploaded;
+}
+
+void LinceSetQuadCulling(LinceBool enable){
+	renderer_state.culling = enable;
+}
+
+void LinceGetSceneViewRect(vec4 rect){
+	glm_vec4_copy(renderer_state.view_rect, rect);
+}
+
+size_t LinceGetRendererDrawnQuads(){
+	return renderer_state.stats.quads_drawn;
+}
+
+size_t LinceGetRendererCulledQuads(){
+	return renderer_state.stats.quads_culled + renderer_state.queue.culled;
+}
+
+size_t LinceGetRendererBatchCount(){
+	return renderer_state.stats.batches;
+}
+
+LinceTexture* LinceGetWhiteTexture(){
+	return renderer_state.white_texture;
+}
+
+void LinceCountCulledQuads(size_t count){
+	renderer_state.stats.quads_culled += count;
 }
 
 void LinceStartNewBatch(){
-	LinceEndScene();
+	LinceFlushBatch();
 	renderer_state.quad_count = 0;
 	renderer_state.texture_slots[0] = renderer_state.white_texture;
 	renderer_state.texture_slot_count = 1;
+	renderer_state.pool_slot_count = 0;
 }
 
-void LinceDrawQuad(LinceQuadProps props) {
-	LINCE_PROFILER_START(timer);
+void LinceSetQuadInstancing(LinceBool enable){
+	if(renderer_state.instancing == enable) return;
+	// quads already submitted are drawn with the previous path
+	LinceDrawQueuedQuads();
+	renderer_state.instancing = enable;
+	LinceMapQuadBatch();
+}
+
+/*
+Packs the slot and layer of a texture into the value stored by LinceWriteQuad.
+Pools take up the slots after those of 2D textures.
+*/
+static inline uint32_t LincePackTextureIndex(uint32_t slot, const LinceTexture* texture){
+	if(!texture || !texture->pool) return slot;
+	return (MAX_TEXTURE_SLOTS + slot) | (texture->layer << 16);
+}
+
+/*
+Returns the batch slot of a texture, or of its pool, adding it if not yet bound.
+The layer of pooled textures is stored in the upper 16 bits.
+Starts a new batch when all slots are taken.
+*/
+static uint32_t LinceGetTextureSlot(LinceTexture* texture){
+	if(!texture) return 0;
+
+	if(texture->pool){
+		// all textures in a pool share one slot
+		uint32_t slots = renderer_state.pool_slot_count;
+		for(uint32_t i = 0; i != slots; ++i){
+			if(texture->pool == renderer_state.pool_slots[i]){
+				return LincePackTextureIndex(i, texture);
+			}
+		}
+		if(slots >= MAX_TEXTURE_POOL_SLOTS){
+			LinceStartNewBatch();
+			slots = renderer_state.pool_slot_count;
+		}
+		renderer_state.pool_slots[slots] = texture->pool;
+		renderer_state.pool_slot_count++;
+		return LincePackTextureIndex(slots, texture);
+	}
 
-	// batch size check
-	if (renderer_state.quad_count >= MAX_QUADS ||
-		renderer_state.texture_slot_count >= MAX_TEXTURE_SLOTS)
-	{
+	// check if texture already in slots
+	uint32_t slots = renderer_state.texture_slot_count;
+	for(uint32_t i = 0; i != slots; ++i){
+		if(texture == renderer_state.texture_slots[i]) return i;
+	}
+	// otherwise add texture
+	if(slots >= MAX_TEXTURE_SLOTS){
 		LinceStartNewBatch();
+		slots = renderer_state.texture_slot_count;
 	}
-	
-	// calculate texture index
-	float texture_index = 0.0f;
-	if(props.tile){
-		props.texture = props.tile->texture;
+	renderer_state.texture_slots[slots] = texture;
+	renderer_state.texture_slot_count++;
+	return slots;
+}
+
+/* Packs an RGBA color in the range [0,1] into four bytes */
+static inline void LincePackColor(const float color[4], uint8_t packed[4]){
+	for(int c = 0; c != 4; ++c){
+		packed[c] = (uint8_t)(glm_clamp(color[c], 0.0f, 1.0f) * 255.0f + 0.5f);
 	}
+}
 
-	if(props.texture){
-		uint32_t slots = renderer_state.texture_slot_count;
+/* Writes the four vertices of a quad given the positions of its corners */
+static inline void LinceWriteQuadCorners(
+	LinceQuadVertex* vertex, const float xs[4], const float ys[4], float z,
+	const uint8_t color[4], const float coords[8], uint32_t texture_index
+){
+	for (uint32_t i = 0; i != QUAD_VERTEX_COUNT; ++i, ++vertex) {
+		vertex->x = xs[i];
+		vertex->y = ys[i];
+		vertex->z = z;
+		vertex->s = coords[i*2];
+		vertex->t = coords[i*2 + 1];
+		memcpy(vertex->color, color, 4);
+		vertex->texture_id = (uint16_t)texture_index;
+		vertex->layer = (uint16_t)(texture_index >> 16);
+	}
+}
 
-		// check if texture already in slots
-		for(uint32_t i = 0; i != slots; ++i){
-			if(props.texture != renderer_state.texture_slots[i]) continue;
-			texture_index = (float)i;
-			break;
- 		}
-		// otherwise add texture
-		if(texture_index <= 0.5f){
-			renderer_state.texture_slots[slots] = props.texture;
-			renderer_state.texture_slot_count++;
-			texture_index = (float)slots;
+/* Writes the four transformed vertices of a quad */
+static inline void LinceWriteQuadVertices(
+	LinceQuadVertex* vertex,
+	float x, float y, float w, float h, float z, float rotation,
+	const uint8_t color[4], const float coords[8], uint32_t texture_index
+){
+	// calculate corner positions
+	float xs[QUAD_VERTEX_COUNT], ys[QUAD_VERTEX_COUNT];
+	LinceTransformQuad(x, y, w, h, rotation, xs, ys);
+	LinceWriteQuadCorners(vertex, xs, ys, z, color, coords, texture_index);
+}
+
+/* Appends one queued quad to the batch, which must have room for it */
+static inline void LinceWriteQuad(const LinceQueuedQuad* q, uint32_t texture_index){
+	// one record per quad, the transform is computed in the vertex shader
+	if(renderer_state.instancing){
+		LinceQuadInstance* instance = renderer_state.instance_batch + renderer_state.quad_count;
+		*instance = (LinceQuadInstance){
+			.x = q->x, .y = q->y, .z = q->z,
+			.w = q->w, .h = q->h,
+			.rotation = q->rotation,
+			// lower left and upper right corners
+			.tex_rect = {q->coords[0], q->coords[1], q->coords[4], q->coords[5]},
+			.color = {q->color[0], q->color[1], q->color[2], q->color[3]},
+			.texture_id = (uint16_t)texture_index,
+			.layer = (uint16_t)(texture_index >> 16)
+		};
+		renderer_state.quad_count++;
+		renderer_state.stats.quads_drawn++;
+		return;
+	}
+
+	// append transformed vertices to batch
+	LinceQuadVertex* vertex = renderer_state.vertex_batch +
+		renderer_state.quad_count * QUAD_VERTEX_COUNT;
+	if(q->transformed){
+		LinceWriteQuadCorners(vertex, q->xs, q->ys, q->z, q->color, q->coords, texture_index);
+	} else {
+		LinceWriteQuadVertices(vertex, q->x, q->y, q->w, q->h, q->z, q->rotation,
+			q->color, q->coords, texture_index);
+	}
+	renderer_state.quad_count++;
+	renderer_state.stats.quads_drawn++;
+}
+
+/* Returns false if culling is enabled and the quad lies outside the view of the camera */
+static inline LinceBool LinceIsQuadVisible(float x, float y, float w, float h, float rotation){
+	if(!renderer_state.culling) return LinceTrue;
+
+	// half size of the box around the quad, which for rotated quads
+	// is bound by half the sum of its sides
+	float hw = fabsf(w) * 0.5f, hh = fabsf(h) * 0.5f;
+	if(rotation != 0.0f) hw = hh = hw + hh;
+
+	const float* view = renderer_state.view_rect;
+	return !(x + hw < view[0] || x - hw > view[2] || y + hh < view[1] || y - hh > view[3]);
+}
+
+/* Returns the number of quads that fit in the batch, starting a new one if full */
+static size_t LinceReserveQuads(){
+	if (renderer_state.quad_count >= MAX_QUADS) LinceStartNewBatch();
+	return MAX_QUADS - renderer_state.quad_count;
+}
+
+/* Makes room for `count` more quads in a quad buffer */
+static void LinceReserveQuadBuffer(LinceQuadBuffer* buffer, size_t count){
+	size_t needed = buffer->count + count;
+	if(needed <= buffer->capacity) return;
+
+	size_t capacity = buffer->capacity ? buffer->capacity : MAX_QUADS;
+	while(capacity < needed) capacity *= 2;
+	buffer->quads = LinceRealloc(buffer->quads, capacity * sizeof(LinceQueuedQuad));
+	buffer->keys = LinceRealloc(buffer->keys, capacity * sizeof(LinceDrawKey));
+	buffer->capacity = capacity;
+}
+
+/*
+Appends a quad to a quad buffer, unless it is culled.
+Only reads the renderer state, so that threads may record quads
+into their own buffers at the same time.
+*/
+static inline void LinceAppendQuad(
+	LinceQuadBuffer* buffer,
+	float x, float y, float w, float h, float z, float rotation,
+	const uint8_t color[4], const float coords[8], LinceTexture* texture
+){
+	if(!LinceIsQuadVisible(x, y, w, h, rotation)){
+		buffer->culled++;
+		return;
+	}
+	LinceReserveQuadBuffer(buffer, 1);
+
+	size_t n = buffer->count++;
+	LinceQueuedQuad* quad = buffer->quads + n;
+	quad->x = x;
+	quad->y = y;
+	quad->w = w;
+	quad->h = h;
+	quad->z = z;
+	quad->rotation = rotation;
+	memcpy(quad->coords, coords, sizeof(quad->coords));
+	memcpy(quad->color, color, sizeof(quad->color));
+	quad->texture = texture;
+
+	// corners are calculated by the recording thread,
+	// unless the vertex shader does it
+	quad->transformed = !renderer_state.instancing;
+	if(quad->transformed) LinceTransformQuad(x, y, w, h, rotation, quad->xs, quad->ys);
+
+	// textures in the same pool are grouped together
+	uint32_t texture_id = 0;
+	if(texture) texture_id = texture->pool ? texture->pool->id : texture->id;
+	LinceBool translucent = color[3] != 0xFF || (texture && !texture->opaque);
+	buffer->keys[n] = (LinceDrawKey){
+		.key = LinceMakeDrawKey(translucent, z, texture_id),
+		.index = (uint32_t)n
+	};
+}
+
+/* Appends an array of quads to a quad buffer */
+static void LinceAppendQuadProps(LinceQuadBuffer* buffer, const LinceQuadProps* props, size_t count){
+	uint8_t color[4];
+	for(size_t i = 0; i != count; ++i){
+		const LinceQuadProps* q = props + i;
+		LincePackColor(q->color, color);
+		LinceAppendQuad(buffer,
+			q->x, q->y, q->w, q->h, q->zorder, q->rotation, color,
+			q->tile ? q->tile->coords : quad_tex_coords,
+			q->tile ? q->tile->texture : q->texture
+		);
+	}
+}
+
+/* Appends quads laid out as separate arrays to a quad buffer */
+static void LinceAppendQuadArrays(LinceQuadBuffer* buffer, const LinceQuadArrays* quads){
+	LINCE_ASSERT(quads && quads->x && quads->y, "Quad positions missing");
+
+	const LinceQuadProps* base = &quads->props;
+	LinceTexture* texture = base->tile ? base->tile->texture : base->texture;
+	const float* coords = base->tile ? base->tile->coords : quad_tex_coords;
+	uint8_t color[4];
+	LincePackColor(base->color, color);
+
+	for(size_t i = 0; i != quads->count; ++i){
+		if(quads->tiles){
+			texture = quads->tiles[i]->texture;
+			coords = quads->tiles[i]->coords;
 		}
+		if(quads->color) LincePackColor(quads->color + i*4, color);
+		LinceAppendQuad(buffer,
+			quads->x[i], quads->y[i],
+			quads->w ? quads->w[i] : base->w,
+			quads->h ? quads->h[i] : base->h,
+			quads->zorder ? quads->zorder[i] : base->zorder,
+			quads->rotation ? quads->rotation[i] : base->rotation,
+			color, coords, texture
+		);
 	}
+}
 
-	// calculate transform
-	mat4 transform = GLM_MAT4_IDENTITY_INIT;
-	vec4 pos = {props.x, props.y, props.zorder, 1.0};
-	vec3 scale = {props.w, props.h, 1.0};
-    glm_translate(transform, pos);
-	glm_rotate(transform, glm_rad(props.rotation), (vec3){0.0, 0.0, -1.0});
-    glm_scale(transform, scale);
+/*
+Sorts the queued quads and writes them to the batch.
+Opaque quads are drawn first, and translucent ones afterwards without writing depth.
+*/
+static void LinceDrawQueuedQuads(){
+	LINCE_PROFILER_START(timer);
 
-	// append transformed vertices to batch
-	for (uint32_t i = 0; i != QUAD_VERTEX_COUNT; ++i) {
-		LinceQuadVertex vertex = {0};
-		vec4 vpos = {quad_vertices[i].x, quad_vertices[i].y, 0.0, 1.0};
-		vec4 res;
-		glm_mat4_mulv(transform, vpos, res);
-		vertex.x = res[0];
-		vertex.y = res[1];
-		vertex.z = res[2];
-
-		if(props.tile){
-			vertex.s = props.tile->coords[i*2];
-			vertex.t = props.tile->coords[i*2 + 1];
-		} else {
-			vertex.s = quad_vertices[i].s;
-			vertex.t = quad_vertices[i].t;
+	LinceQuadBuffer* queue = &renderer_state.queue;
+	if(renderer_state.scratch_capacity < queue->count){
+		renderer_state.queue_scratch = LinceRealloc(renderer_state.queue_scratch,
+			queue->capacity * sizeof(LinceDrawKey));
+		renderer_state.scratch_capacity = queue->capacity;
+	}
+	LinceSortDrawKeys(queue->keys, renderer_state.queue_scratch, queue->count);
+
+	LinceTexture* texture = NULL;
+	uint32_t texture_index = 0;
+	LinceBool translucent = LinceFalse;
+
+	for(size_t i = 0; i != queue->count; ++i){
+		const LinceQueuedQuad* q = queue->quads + queue->keys[i].index;
+		if(!translucent && (queue->keys[i].key >> 63)){
+			// opaque quads all drawn
+			LinceStartNewBatch();
+			glDepthMask(GL_FALSE);
+			translucent = LinceTrue;
 		}
 
-		vertex.texture_id = texture_index;
-		memcpy(vertex.color, props.color, sizeof(float)*4);
-		size_t offset = renderer_state.quad_count * QUAD_VERTEX_COUNT + i;
-		memcpy(renderer_state.vertex_batch + offset, &vertex, sizeof(vertex));
+		LinceReserveQuads();
+		// slots are reset with every new batch
+		if(renderer_state.quad_count == 0 || q->texture != texture){
+			texture_index = LinceGetTextureSlot(q->texture);
+			texture = q->texture;
+		}
+		LinceWriteQuad(q, texture_index);
 	}
-	renderer_state.quad_count++;
-	
+
+	LinceStartNewBatch();
+	if(translucent) glDepthMask(GL_TRUE);
+	queue->count = 0;
+
+	LINCE_PROFILER_END(timer);
+}
+
+void LinceDrawQuad(LinceQuadProps props) {
+	LINCE_PROFILER_START(timer);
+	LinceAppendQuadProps(&renderer_state.queue, &props, 1);
+	LINCE_PROFILER_END(timer);
+}
+
+void LinceDrawQuads(const LinceQuadProps* props, size_t count) {
+	LINCE_PROFILER_START(timer);
+	LinceAppendQuadProps(&renderer_state.queue, props, count);
+	LINCE_PROFILER_END(timer);
+}
+
+void LinceDrawQuadArrays(const LinceQuadArrays* quads) {
+	LINCE_PROFILER_START(timer);
+	LinceAppendQuadArrays(&renderer_state.queue, quads);
+	LINCE_PROFILER_END(timer);
+}
+
+
+LinceQuadBuffer* LinceCreateQuadBuffer(){
+	return LinceCalloc(sizeof(LinceQuadBuffer));
+}
+
+void LinceRecordQuad(LinceQuadBuffer* buffer, LinceQuadProps props){
+	LinceAppendQuadProps(buffer, &props, 1);
+}
+
+void LinceRecordQuads(LinceQuadBuffer* buffer, const LinceQuadProps* props, size_t count){
+	LinceAppendQuadProps(buffer, props, count);
+}
+
+void LinceRecordQuadArrays(LinceQuadBuffer* buffer, const LinceQuadArrays* quads){
+	LinceAppendQuadArrays(buffer, quads);
+}
+
+void LinceSubmitQuadBuffer(LinceQuadBuffer* buffer){
+	LINCE_PROFILER_START(timer);
+	LINCE_ASSERT(buffer, "Quad buffer missing");
+
+	LinceQuadBuffer* queue = &renderer_state.queue;
+	LinceReserveQuadBuffer(queue, buffer->count);
+	memcpy(queue->quads + queue->count, buffer->quads,
+		buffer->count * sizeof(LinceQueuedQuad));
+
+	// keys index the quads of the buffer, which now come after those of the queue
+	LinceDrawKey* keys = queue->keys + queue->count;
+	for(size_t i = 0; i != buffer->count; ++i){
+		keys[i].key = buffer->keys[i].key;
+		keys[i].index = buffer->keys[i].index + (uint32_t)queue->count;
+	}
+	queue->count += buffer->count;
+	renderer_state.stats.quads_culled += buffer->culled;
+
+	buffer->count = 0;
+	buffer->culled = 0;
+	LINCE_PROFILER_END(timer);
+}
+
+void LinceDeleteQuadBuffer(LinceQuadBuffer* buffer){
+	if(!buffer) return;
+	LinceFree(buffer->quads);
+	LinceFree(buffer->keys);
+	LinceFree(buffer);
+}
+
+
+LinceQuadMesh* LinceCreateQuadMesh(size_t capacity){
+	LINCE_ASSERT(capacity > 0 && capacity <= MAX_QUADS,
+		"Quad mesh capacity must be between 1 and %d", MAX_QUADS);
+
+	LinceQuadMesh* mesh = LinceCalloc(sizeof(LinceQuadMesh));
+	mesh->capacity = capacity;
+	mesh->vb = LinceCreateVertexBuffer(NULL,
+		(unsigned int)(capacity * QUAD_VERTEX_COUNT * sizeof(LinceQuadVertex))
+	);
+	// quads are indexed with the first indices of the renderer's index buffer,
+	// which is not handed over to the vertex array so that it is not deleted with it
+	mesh->va = LinceCreateVertexArray((LinceIndexBuffer){0});
+	LinceAddVertexArrayAttributes(
+		mesh->va, mesh->vb, quad_vertex_layout,
+		sizeof(quad_vertex_layout) / sizeof(LinceBufferElement)
+	);
+	LinceBindIndexBuffer(renderer_state.ib);
+	LinceBindVertexArray(renderer_state.va);
+	return mesh;
+}
+
+/* Returns the slot of a texture in a quad mesh, adding it if not yet used.
+Packed with its layer if pooled, see LincePackTextureIndex */
+static uint32_t LinceGetQuadMeshTextureSlot(LinceQuadMesh* mesh, LinceTexture* texture){
+	if(!texture) return 0;
+
+	if(texture->pool){
+		for(uint32_t i = 0; i < mesh->pool_count; ++i){
+			if(texture->pool == mesh->pools[i]) return LincePackTextureIndex(i, texture);
+		}
+		LINCE_ASSERT(mesh->pool_count < LINCE_QUAD_MESH_POOLS,
+			"Quad mesh cannot use more than %d texture pools", LINCE_QUAD_MESH_POOLS);
+		mesh->pools[mesh->pool_count] = texture->pool;
+		return LincePackTextureIndex(mesh->pool_count++, texture);
+	}
+
+	for(uint32_t i = 1; i < mesh->texture_count; ++i){
+		if(texture == mesh->textures[i]) return i;
+	}
+	LINCE_ASSERT(mesh->texture_count < LINCE_QUAD_MESH_TEXTURES,
+		"Quad mesh cannot use more than %d textures", LINCE_QUAD_MESH_TEXTURES - 1);
+	mesh->textures[mesh->texture_count] = texture;
+	return mesh->texture_count++;
+}
+
+void LinceSetQuadMeshData(LinceQuadMesh* mesh, const LinceQuadArrays* quads){
+	LINCE_PROFILER_START(timer);
+	LINCE_ASSERT(mesh, "Quad mesh missing");
+	LINCE_ASSERT(quads && quads->x && quads->y, "Quad positions missing");
+	LINCE_ASSERT(quads->count <= mesh->capacity,
+		"Too many quads for mesh (%d but capacity is %d)",
+		(int)quads->count, (int)mesh->capacity);
+
+	mesh->quad_count = quads->count;
+	mesh->texture_count = 1; // slot 0 is the default white texture
+	mesh->pool_count = 0;
+	if(quads->count == 0){
+		LINCE_PROFILER_END(timer);
+		return;
+	}
+
+	const LinceQuadProps* base = &quads->props;
+	LinceTexture* texture = base->tile ? base->tile->texture : base->texture;
+	const float* coords = base->tile ? base->tile->coords : quad_tex_coords;
+	uint32_t texture_index = LinceGetQuadMeshTextureSlot(mesh, texture);
+	uint8_t color[4];
+	LincePackColor(base->color, color);
+
+	size_t size = quads->count * QUAD_VERTEX_COUNT * sizeof(LinceQuadVertex);
+	LinceQuadVertex* vertices = LinceMalloc(size);
+
+	for(size_t i = 0; i != quads->count; ++i){
+		if(quads->tiles){
+			const LinceTile* tile = quads->tiles[i];
+			coords = tile->coords;
+			if(i == 0 || tile->texture != texture){
+				texture_index = LinceGetQuadMeshTextureSlot(mesh, tile->texture);
+				texture = tile->texture;
+			}
+		}
+		if(quads->color) LincePackColor(quads->color + i*4, color);
+		LinceWriteQuadVertices(
+			vertices + i * QUAD_VERTEX_COUNT,
+			quads->x[i], quads->y[i],
+			quads->w ? quads->w[i] : base->w,
+			quads->h ? quads->h[i] : base->h,
+			quads->zorder ? quads->zorder[i] : base->zorder,
+			quads->rotation ? quads->rotation[i] : base->rotation,
+			color, coords, texture_index
+		);
+	}
+
+	LinceSetVertexBufferData(mesh->vb, vertices, (unsigned int)size);
+	LinceFree(vertices);
 	LINCE_PROFILER_END(timer);
 }
 
+void LinceDrawQuadMesh(LinceQuadMesh* mesh, mat4 transform){
+	if(!mesh || mesh->quad_count == 0) return;
+	LINCE_PROFILER_START(timer);
+
+	// drawn straight away, before the queued quads which are drawn at the end of the scene
+	LinceStartNewBatch();
+
+	LinceBindTexture(renderer_state.white_texture, 0);
+	for(uint32_t i = 1; i < mesh->texture_count; ++i){
+		LinceBindTexture(mesh->textures[i], i);
+	}
+	for(uint32_t i = 0; i < mesh->pool_count; ++i){
+		LinceBindTexturePool(mesh->pools[i], MAX_TEXTURE_SLOTS + i);
+	}
+	renderer_state.stats.texture_binds += mesh->texture_count + mesh->pool_count;
+	LinceBindShader(renderer_state.mesh_shader);
+	if(transform){
+		LinceSetShaderUniformMat4ByID(renderer_state.mesh_shader, renderer_state.mesh_transform_id, transform);
+	}
+	LinceBindVertexArray(mesh->va);
+	LinceBindIndexBuffer(renderer_state.ib);
+	glDrawElements(GL_TRIANGLES,
+		(GLsizei)(mesh->quad_count * QUAD_INDEX_COUNT), GL_UNSIGNED_INT, 0
+	);
+	renderer_state.stats.quads_drawn += mesh->quad_count;
+	renderer_state.stats.batches++;
+	renderer_state.stats.draw_calls++;
+	if(transform){
+		mat4 identity = GLM_MAT4_IDENTITY_INIT;
+		LinceSetShaderUniformMat4ByID(renderer_state.mesh_shader, renderer_state.mesh_transform_id, identity);
+	}
+
+	LINCE_PROFILER_END(timer);
+}
+
+void LinceDeleteQuadMesh(LinceQuadMesh* mesh){
+	if(!mesh) return;
+	LinceDeleteVertexArray(mesh->va); // also deletes its vertex buffer
+	LinceFree(mesh);
+}
@@ -31,6 +31,59 @@ typedef struct LinceQuadProps{
 	LinceTile* tile;
 } LinceQuadProps;
 
+/*
+Quad properties laid out as separate arrays, serves as argument for LinceDrawQuadArrays.
+Arrays left NULL take the value in `props` for every quad.
+*/
+typedef struct LinceQuadArrays{
+	size_t count;            // number of quads
+	const float* x;          // x positions, required
+	const float* y;          // y positions, required
+	const float* w;          // widths
+	const float* h;          // heights
+	const float* zorder;     // orders of rendering
+	const float* rotation;   // clockwise rotations in degrees
+	const float* color;      // flat quad colors, four rgba values per quad
+	LinceTile* const* tiles; // tiles, replace `props.tile` and `props.texture`
+	LinceQuadProps props;    // properties shared by all quads
+} LinceQuadArrays;
+
+/*
+Per-scene data shared by all shaders through a uniform buffer, with std140 layout.
+Shaders read it by declaring LINCE_SCENE_UNIFORM_GLSL.
+*/
+typedef struct LinceSceneUniforms {
+	float view_proj[4][4];     // view-projection matrix of the scene camera
+	float view_proj_inv[4][4]; // inverse view-projection matrix
+	float screen_size[2];      // size of the screen in pixels
+	float time;                // clock in milliseconds
+	float dt;                  // timestep in milliseconds
+} LinceSceneUniforms;
+
+/*
+Number of scenes whose data is kept in the uniform buffer at once.
+Each call to LinceBeginScene writes to the next range of the buffer and binds it,
+so that scenes with different cameras do not overwrite each other's data.
+*/
+#define LINCE_SCENE_UNIFORM_SLOTS 64
+
+/* Number of frames over which frame time statistics are kept */
+#define LINCE_FRAME_TIME_SAMPLES 240
+
+/* Rendering work of a frame, see LinceGetRendererStats */
+typedef struct LinceRendererStats {
+	size_t scenes;         // scenes ended with LinceEndScene
+	size_t quads_drawn;    // quads drawn
+	size_t quads_culled;   // quads skipped outside the view of the camera
+	size_t batches;        // batches of quads drawn, including quad meshes
+	size_t draw_calls;     // OpenGL draw calls, including LinceDrawIndexed
+	size_t texture_binds;  // textures and pools bound for drawing
+	size_t bytes_uploaded; // vertex data sent to the GPU
+	// frame times in milliseconds, the last one and over the last LINCE_FRAME_TIME_SAMPLES
+	float frame_ms, frame_min_ms, frame_avg_ms, frame_p99_ms;
+	float gpu_ms; // time the GPU spent on a recent frame, see LinceGetGPUFrameTime
+} LinceRendererStats;
+
 /* Initialises renderer state and openGL rendering settings */
 void LinceInitRenderer();
 
@@ -40,10 +93,67 @@ void LinceTerminateRenderer();
 /* Begins rendering scene */
 void LinceBeginScene(LinceCamera* cam);
 
-/* Renders scene and flushes batch buffers */
+/*
+Renders scene and flushes batch buffers.
+Submitted quads are sorted: opaque ones are drawn first, grouped by texture and from front to back,
+and translucent ones (with a texture that has transparent pixels, or a color with alpha below 1)
+are drawn afterwards from back to front.
+*/
 void LinceEndScene();
 
-/* Submits a quad for rendering
+/*
+Switches between drawing quads from four transformed vertices each (default),
+and drawing them as instances of a single quad transformed in the vertex shader,
+which takes less CPU time and bandwidth per quad.
+Instanced quads use the lower left and upper right texture coordinates of tiles.
+Quads already submitted are flushed before switching.
+*/
+void LinceSetQuadInstancing(LinceBool enable);
+
+/* Returns the number of bytes of vertex data uploaded
+to the GPU since the last call to LinceBeginScene */
+size_t LinceGetRendererUploadedBytes();
+
+/*
+Enables skipping quads that lie outside the view of the scene camera.
+Disabled by default.
+*/
+void LinceSetQuadCulling(LinceBool enable);
+
+/* Returns the world rectangle {xmin, ymin, xmax, ymax}
+seen by the camera passed to LinceBeginScene */
+void LinceGetSceneViewRect(vec4 rect);
+
+/* Returns the number of quads drawn since the last call to LinceBeginScene */
+size_t LinceGetRendererDrawnQuads();
+
+/* Returns the number of quads culled since the last call to LinceBeginScene */
+size_t LinceGetRendererCulledQuads();
+
+/* Returns the number of batches drawn since the last call to LinceBeginScene,
+one per draw call */
+size_t LinceGetRendererBatchCount();
+
+/*
+Returns the statistics of the last frame.
+Counters are reset on LinceBeginScene and added up over all scenes of a frame.
+*/
+LinceRendererStats LinceGetRendererStats();
+
+/*
+Finishes the statistics of a frame given its timestep in milliseconds,
+and starts those of the next one. Called by the app at the end of each frame.
+*/
+void LinceEndRendererFrame(float dt);
+
+/* Returns the 1x1 white texture drawn by quads without a texture */
+LinceTexture* LinceGetWhiteTexture();
+
+/* Adds to the count of culled quads, for geometry culled before being submitted */
+void LinceCountCulledQuads(size_t count);
+
+/* Submits a quad for rendering at the end of the scene.
+Textures must remain valid until LinceEndScene.
 e.g LinceSubmitQuad({.x=1.0, .y=2.0});
 C99 standard guarantees that uninitialised members
 are set to zero if at least one has been initialised
@@ -51,6 +161,89 @@ within the brace-enclosed list.
 */
 void LinceDrawQuad(LinceQuadProps props);
 
+/*
+Submits an array of quads for rendering.
+Faster than calling LinceDrawQuad for each quad, as quads are not passed by value.
+*/
+void LinceDrawQuads(const LinceQuadProps* props, size_t count);
+
+/*
+Submits quads whose properties are given as separate arrays,
+so that only the properties that differ between quads are stored.
+e.g. LinceDrawQuadArrays(&(LinceQuadArrays){
+	.count = n, .x = xs, .y = ys,
+	.props = {.w = 1.0, .h = 1.0, .color = {1,1,1,1}}
+});
+*/
+void LinceDrawQuadArrays(const LinceQuadArrays* quads);
+
+
+/*
+Quads recorded for drawing at the end of the scene, which threads other than
+the rendering one can fill at the same time, one buffer per thread.
+Recording threads also cull the quads and calculate their vertices.
+*/
+typedef struct LinceQuadBuffer LinceQuadBuffer;
+
+/* Creates an empty quad buffer */
+LinceQuadBuffer* LinceCreateQuadBuffer();
+
+/*
+Record quads into a buffer, like LinceDrawQuad, LinceDrawQuads and LinceDrawQuadArrays.
+May be called from any thread between LinceBeginScene and LinceSubmitQuadBuffer,
+as long as only one thread uses each buffer.
+*/
+void LinceRecordQuad(LinceQuadBuffer* buffer, LinceQuadProps props);
+void LinceRecordQuads(LinceQuadBuffer* buffer, const LinceQuadProps* props, size_t count);
+void LinceRecordQuadArrays(LinceQuadBuffer* buffer, const LinceQuadArrays* quads);
+
+/*
+Adds the quads recorded in a buffer to the scene, and empties the buffer.
+Must be called from the rendering thread before LinceEndScene,
+once the recording thread is done with the buffer.
+*/
+void LinceSubmitQuadBuffer(LinceQuadBuffer* buffer);
+
+/* Deletes a quad buffer */
+void LinceDeleteQuadBuffer(LinceQuadBuffer* buffer);
+
+
+/* Max number of textures a quad mesh may use, including the default white texture */
+#define LINCE_QUAD_MESH_TEXTURES 28
+/* Max number of texture pools a quad mesh may use */
+#define LINCE_QUAD_MESH_POOLS 4
+
+/*
+Quads whose vertices are built once and kept in GPU memory,
+so that they can be drawn every frame without being submitted again.
+Suited to static geometry such as the grids of tilemaps.
+*/
+typedef struct LinceQuadMesh{
+	LinceVertexArray* va;
+	LinceVertexBuffer vb;
+	size_t quad_count;      // number of quads stored
+	size_t capacity;        // max number of quads
+	uint32_t texture_count; // number of texture slots used
+	LinceTexture* textures[LINCE_QUAD_MESH_TEXTURES]; // textures in each slot
+	uint32_t pool_count;    // number of texture pool slots used
+	LinceTexturePool* pools[LINCE_QUAD_MESH_POOLS]; // texture pools in each slot
+} LinceQuadMesh;
+
+/* Creates a quad mesh with room for `capacity` quads */
+LinceQuadMesh* LinceCreateQuadMesh(size_t capacity);
+
+/* Replaces the quads stored in a mesh and uploads their vertices */
+void LinceSetQuadMeshData(LinceQuadMesh* mesh, const LinceQuadArrays* quads);
+
+/*
+Draws the quads of a mesh, moved by an optional `transform` (may be NULL).
+Meshes are drawn straight away, before quads submitted with LinceDrawQuad,
+and pixels with an alpha of zero are discarded.
+*/
+void LinceDrawQuadMesh(LinceQuadMesh* mesh, mat4 transform);
+
+/* Deletes a quad mesh and its GPU buffers */
+void LinceDeleteQuadMesh(LinceQuadMesh* mesh);
 
 /* Draws provided vertices directly */
 void LinceDrawIndexed(
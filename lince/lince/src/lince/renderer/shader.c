@@ -4,6 +4,26 @@
 #include <glad/glad.h>
 //#include <cglm>
 
+#ifdef LINCE_WINDOWS
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#define LINCE_SHADER_BINARY_MAGIC "LSHD"
+
+/* Header of a cached program binary file, followed by the binary */
+typedef struct LinceShaderBinaryHeader {
+	char magic[4];   // LINCE_SHADER_BINARY_MAGIC
+	uint32_t format; // driver-specific binary format
+	uint64_t key;    // hash of the sources and the driver
+	uint32_t length; // bytes of the binary
+	uint32_t reserved;
+} LinceShaderBinaryHeader;
+
+/* Directory of cached program binaries, empty if disabled */
+static char shader_cache_dir[LINCE_NAME_MAX] = "";
+
 
 
 
@@ -16,9 +36,30 @@ static char* LinceReadFile(const char* path);
 /* Compiles a shader file from source, returns OpenGL ID */
 static int LinceCompileShader(const char* source, int type);
 
+/* Caches the locations of all active uniforms of a linked shader */
+static void LinceCacheShaderUniforms(LinceShader* shader);
+
+/* Returns a hash of the shader sources and the OpenGL driver, which identifies a program binary */
+static uint64_t LinceGetShaderBinaryKey(const char* vertex_src, const char* fragment_src);
+
+/* Links a program from a cached binary, returns false if missing or rejected by the driver */
+static LinceBool LinceLoadShaderBinary(LinceShader* shader, uint64_t key);
+
+/* Writes the binary of a linked program to the cache */
+static void LinceSaveShaderBinary(LinceShader* shader, uint64_t key);
+
 
 /* --- Public API --- */
 
+void LinceSetShaderCacheDir(const char* dir){
+	if(!dir){
+		shader_cache_dir[0] = '\0';
+		return;
+	}
+	LINCE_ASSERT(strlen(dir) < LINCE_NAME_MAX, "Shader cache path is too long: '%s'", dir);
+	strcpy(shader_cache_dir, dir);
+}
+
 /* Create shader from paths to vertex and fragment shader source files */
 LinceShader* LinceCreateShader(
 	const char* name,
@@ -59,26 +100,40 @@ LinceShader* LinceCreateShaderFromSrc(
 	memcpy(shader->name, name, strlen(name));
 	shader->id = glCreateProgram();
 
-	LINCE_INFO(" Compiling Vertex and Fragment Sources for '%s'", name);
-	int vs, fs;
-	vs = LinceCompileShader(vertex_src, GL_VERTEX_SHADER);
-	fs = LinceCompileShader(fragment_src, GL_FRAGMENT_SHADER);
+	// program binaries require OpenGL 4.1
+	LinceBool cached = shader_cache_dir[0] && GLAD_GL_VERSION_4_1;
+	uint64_t key = cached ? LinceGetShaderBinaryKey(vertex_src, fragment_src) : 0;
+	if(cached && LinceLoadShaderBinary(shader, key)){
+		LINCE_INFO(" Loaded Shader '%s' from cache", name);
+	} else {
+		LINCE_INFO(" Compiling Vertex and Fragment Sources for '%s'", name);
+		int vs, fs;
+		vs = LinceCompileShader(vertex_src, GL_VERTEX_SHADER);
+		fs = LinceCompileShader(fragment_src, GL_FRAGMENT_SHADER);
+
+		LINCE_INFO(" Linking and Validating Shader '%s'", name);
+		glAttachShader(shader->id, vs);
+		glAttachShader(shader->id, fs);
+		if(cached) glProgramParameteri(shader->id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(shader->id);
+		glValidateProgram(shader->id);
+		
+		//compiled shader files are no longer necessary
+		glDetachShader(shader->id, vs);
+		glDetachShader(shader->id, fs);
+		glDeleteShader(vs);
+		glDeleteShader(fs);
+
+		if(cached) LinceSaveShaderBinary(shader, key);
+	}
 
-	LINCE_INFO(" Linking and Validating Shader '%s'", name);
-	glAttachShader(shader->id, vs);
-	glAttachShader(shader->id, fs);
-	glLinkProgram(shader->id);
-	glValidateProgram(shader->id);
-	
-	//compiled shader files are no longer necessary
-	glDeleteShader(vs);
-	glDeleteShader(fs);
+	LinceCacheShaderUniforms(shader);
 
-	// start out with hashmap of 21 buckets to avoid costs of
-	// resizing often at small sizes (e.g. at sizes 2, 3, 5, 7, 11, etc).
-	hashmap_t uniforms = hashmap_create(20);
-	LINCE_ASSERT(uniforms.table, "Failed to create hashmap for shader uniforms");
-	memmove(&shader->uniforms, &uniforms, sizeof(hashmap_t));
+	// reads per-scene data from the renderer's uniform buffer
+	unsigned int block = glGetUniformBlockIndex(shader->id, LINCE_SCENE_UNIFORM_BLOCK);
+	if(block != GL_INVALID_INDEX){
+		glUniformBlockBinding(shader->id, block, LINCE_SCENE_UNIFORM_BINDING);
+	}
 
 	LINCE_PROFILER_END(timer);
     return shader;
@@ -113,24 +168,19 @@ int LinceGetShaderUniformID(LinceShader* shader, const char* name){
 
 	/*
 	Uniform locations are saved as void* addresses in the hashmap
-	to avoid allocating memory and freein it afterwards.
-	The void* type should be 64 bits long (in 64bit systems), matching a long int.
+	to avoid allocating memory and freeing it afterwards.
+	They are offset by two so that neither a missing uniform (-1) nor location 0
+	is stored as NULL, which the hashmap rejects, and misses are cached as well.
 	*/
-
-	long location;
-
-	if(hashmap_has_key(&shader->uniforms, name)){
-		location = (long)hashmap_get(&shader->uniforms, name);
+	intptr_t cached = (intptr_t)hashmap_get(&shader->uniforms, name);
+	if(cached){
 		LINCE_PROFILER_END(timer);
-		return (int)location;
+		return (int)(cached - 2);
 	}
-	
-	location = glGetUniformLocation(shader->id, name);
-	hashmap_set(&shader->uniforms, name, (void*)location);
-	
-	// Implementation without hashmap - slower?
-	// int location =  glGetUniformLocation(shader->id, name);
-	
+
+	// not active when linked, e.g. an element of an array or a missing uniform
+	intptr_t location = glGetUniformLocation(shader->id, name);
+	hashmap_set(&shader->uniforms, name, (void*)(location + 2));
 	if(location < 0){
 		LINCE_INFO(" Uniform '%s' not found in shader '%s'", name, shader->name);
 	}
@@ -141,8 +191,7 @@ int LinceGetShaderUniformID(LinceShader* shader, const char* name){
 
 /* Set integer uniform */
 void LinceSetShaderUniformInt(LinceShader* sh, const char* name, int val){
-	int loc = LinceGetShaderUniformID(sh, name);
-	glUniform1i(loc, val);
+	LinceSetShaderUniformIntByID(sh, LinceGetShaderUniformID(sh, name), val);
 }
 
 /* Set integer array uniform */
@@ -150,44 +199,71 @@ void LinceSetShaderUniformIntN(
 	LinceShader* sh, const char* name,
 	int* arr, unsigned int count
 ) {
-	int loc = LinceGetShaderUniformID(sh, name);
-	glUniform1iv(loc, count, arr);
+	LinceSetShaderUniformIntNByID(sh, LinceGetShaderUniformID(sh, name), arr, count);
 }
 
 /* Set float uniform */
 void LinceSetShaderUniformFloat(LinceShader* sh, const char* name, float val){
-	int loc = LinceGetShaderUniformID(sh, name);
-	glUniform1f(loc, val);
+	LinceSetShaderUniformFloatByID(sh, LinceGetShaderUniformID(sh, name), val);
 }
 
 /* Set vec2 uniform */
 void LinceSetShaderUniformVec2(LinceShader* sh, const char* name, vec2 v){
-	int loc = LinceGetShaderUniformID(sh, name);
-	glUniform2f(loc, v[0], v[1]);
+	LinceSetShaderUniformVec2ByID(sh, LinceGetShaderUniformID(sh, name), v);
 }
 
 /* Set vec3 uniform */
 void LinceSetShaderUniformVec3(LinceShader* sh, const char* name, vec3 v){
-	int loc = LinceGetShaderUniformID(sh, name);
-	glUniform3f(loc, v[0], v[1], v[2]);
+	LinceSetShaderUniformVec3ByID(sh, LinceGetShaderUniformID(sh, name), v);
 }
 
 /* Set vec4 uniform */
 void LinceSetShaderUniformVec4(LinceShader* sh, const char* name, vec4 v){
-	int loc = LinceGetShaderUniformID(sh, name);
-	glUniform4f(loc, v[0], v[1], v[2], v[3]);
+	LinceSetShaderUniformVec4ByID(sh, LinceGetShaderUniformID(sh, name), v);
 }
 
 /* Set mat3 uniform */
 void LinceSetShaderUniformMat3(LinceShader* sh, const char* name, mat3 m){
-	int loc = LinceGetShaderUniformID(sh, name);
-	glUniformMatrix3fv(loc, 1, GL_FALSE, &m[0][0]);
+	LinceSetShaderUniformMat3ByID(sh, LinceGetShaderUniformID(sh, name), m);
 }
 
 /* Set mat4 uniform */
 void LinceSetShaderUniformMat4(LinceShader* sh, const char* name, mat4 m){
-	int loc = LinceGetShaderUniformID(sh, name);
-	glUniformMatrix4fv(loc, 1, GL_FALSE, &m[0][0]);
+	LinceSetShaderUniformMat4ByID(sh, LinceGetShaderUniformID(sh, name), m);
+}
+
+/* Uniform setters by ID, through direct state access so that the shader need not be bound */
+
+void LinceSetShaderUniformIntByID(LinceShader* sh, int id, int val){
+	glProgramUniform1i(sh->id, id, val);
+}
+
+void LinceSetShaderUniformIntNByID(LinceShader* sh, int id, int* arr, unsigned int count){
+	glProgramUniform1iv(sh->id, id, (GLsizei)count, arr);
+}
+
+void LinceSetShaderUniformFloatByID(LinceShader* sh, int id, float val){
+	glProgramUniform1f(sh->id, id, val);
+}
+
+void LinceSetShaderUniformVec2ByID(LinceShader* sh, int id, vec2 v){
+	glProgramUniform2f(sh->id, id, v[0], v[1]);
+}
+
+void LinceSetShaderUniformVec3ByID(LinceShader* sh, int id, vec3 v){
+	glProgramUniform3f(sh->id, id, v[0], v[1], v[2]);
+}
+
+void LinceSetShaderUniformVec4ByID(LinceShader* sh, int id, vec4 v){
+	glProgramUniform4f(sh->id, id, v[0], v[1], v[2], v[3]);
+}
+
+void LinceSetShaderUniformMat3ByID(LinceShader* sh, int id, mat3 m){
+	glProgramUniformMatrix3fv(sh->id, id, 1, GL_FALSE, &m[0][0]);
+}
+
+void LinceSetShaderUniformMat4ByID(LinceShader* sh, int id, mat4 m){
+	glProgramUniformMatrix4fv(sh->id, id, 1, GL_FALSE, &m[0][0]);
 }
 
 
@@ -238,4 +314,147 @@ int LinceCompileShader(const char* source, int type){
 	
 	LINCE_PROFILER_END(timer);
 	return id;
-}
\ No newline at end of file
+}
+
+
+static void LinceCacheShaderUniforms(LinceShader* shader){
+	LINCE_PROFILER_START(timer);
+
+	int count = 0, max_length = 0;
+	glGetProgramiv(shader->id, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(shader->id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+	// sized for the active uniforms and the names of arrays without "[0]"
+	hashmap_t uniforms = hashmap_create((uint32_t)count * 2 + 1);
+	LINCE_ASSERT(uniforms.table, "Failed to create hashmap for shader uniforms");
+	memmove(&shader->uniforms, &uniforms, sizeof(hashmap_t));
+
+	char* name = calloc((size_t)max_length + 1, sizeof(char));
+	LINCE_ASSERT_ALLOC(name, max_length + 1);
+	for(int i = 0; i != count; ++i){
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(shader->id, (GLuint)i, max_length, &length, &size, &type, name);
+		
+		// members of uniform blocks have no location, offset as in LinceGetShaderUniformID
+		intptr_t location = glGetUniformLocation(shader->id, name);
+		if(location < 0) continue;
+		hashmap_set(&shader->uniforms, name, (void*)(location + 2));
+
+		// arrays are listed by their first element, and may be set by their bare name too
+		if(length > 3 && strcmp(name + length - 3, "[0]") == 0){
+			name[length - 3] = '\0';
+			hashmap_set(&shader->uniforms, name, (void*)(location + 2));
+		}
+	}
+	free(name);
+
+	LINCE_INFO(" Cached %d uniforms of shader '%s'", count, shader->name);
+	LINCE_PROFILER_END(timer);
+}
+
+
+static uint64_t LinceGetShaderBinaryKey(const char* vertex_src, const char* fragment_src){
+	// FNV-1a over the sources and the driver strings, separated by their terminators
+	const char* parts[] = {
+		vertex_src, fragment_src,
+		(const char*)glGetString(GL_VENDOR),
+		(const char*)glGetString(GL_RENDERER),
+		(const char*)glGetString(GL_VERSION)
+	};
+	uint64_t hash = 14695981039346656037ULL;
+	for(size_t i = 0; i != sizeof(parts) / sizeof(parts[0]); ++i){
+		const char* c = parts[i] ? parts[i] : "";
+		do {
+			hash ^= (unsigned char)*c;
+			hash *= 1099511628211ULL;
+		} while(*c++);
+	}
+	return hash;
+}
+
+/*
+Writes the path of the cached binary of a shader into `path`.
+Characters of the shader name other than letters, digits, '-' and '_' become '_',
+so that the name cannot point outside the cache directory.
+*/
+static void LinceGetShaderBinaryPath(LinceShader* shader, uint64_t key, char* path, size_t size){
+	char name[LINCE_NAME_MAX] = {0};
+	for(size_t i = 0; shader->name[i] && i != LINCE_NAME_MAX - 1; ++i){
+		char c = shader->name[i];
+		LinceBool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+			(c >= '0' && c <= '9') || c == '-' || c == '_';
+		name[i] = safe ? c : '_';
+	}
+	snprintf(path, size, "%s/%s-%016llx.bin", shader_cache_dir, name, (unsigned long long)key);
+}
+
+static LinceBool LinceLoadShaderBinary(LinceShader* shader, uint64_t key){
+	LINCE_PROFILER_START(timer);
+	char path[LINCE_NAME_MAX * 3];
+	LinceGetShaderBinaryPath(shader, key, path, sizeof(path));
+	FILE* file = fopen(path, "rb");
+	if(!file){
+		LINCE_PROFILER_END(timer);
+		return LinceFalse;
+	}
+
+	LinceShaderBinaryHeader header;
+	void* binary = NULL;
+	LinceBool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+		memcmp(header.magic, LINCE_SHADER_BINARY_MAGIC, 4) == 0 &&
+		header.key == key && header.length > 0;
+	if(ok){
+		binary = malloc(header.length);
+		ok = binary && fread(binary, header.length, 1, file) == 1;
+	}
+	fclose(file);
+
+	// the driver rejects binaries from other versions, in which case the shader is compiled
+	int linked = GL_FALSE;
+	if(ok){
+		glProgramBinary(shader->id, header.format, binary, (GLsizei)header.length);
+		glGetProgramiv(shader->id, GL_LINK_STATUS, &linked);
+	}
+	free(binary);
+	if(!linked) LINCE_INFO(" Invalid shader cache '%s'", path);
+	LINCE_PROFILER_END(timer);
+	return linked == GL_TRUE;
+}
+
+static void LinceSaveShaderBinary(LinceShader* shader, uint64_t key){
+	LINCE_PROFILER_START(timer);
+	int linked = GL_FALSE, length = 0;
+	glGetProgramiv(shader->id, GL_LINK_STATUS, &linked);
+	glGetProgramiv(shader->id, GL_PROGRAM_BINARY_LENGTH, &length);
+	if(linked != GL_TRUE || length <= 0){
+		LINCE_PROFILER_END(timer);
+		return;
+	}
+
+	LinceShaderBinaryHeader header = {.magic = LINCE_SHADER_BINARY_MAGIC, .key = key};
+	void* binary = malloc((size_t)length);
+	LINCE_ASSERT_ALLOC(binary, length);
+	GLenum format = 0;
+	GLsizei written = 0;
+	glGetProgramBinary(shader->id, length, &written, &format, binary);
+	header.format = format;
+	header.length = (uint32_t)written;
+
+#ifdef LINCE_WINDOWS
+	_mkdir(shader_cache_dir);
+#else
+	mkdir(shader_cache_dir, 0755);
+#endif
+	char path[LINCE_NAME_MAX * 3];
+	LinceGetShaderBinaryPath(shader, key, path, sizeof(path));
+	FILE* file = written > 0 ? fopen(path, "wb") : NULL;
+	LinceBool ok = file &&
+		fwrite(&header, sizeof(header), 1, file) == 1 &&
+		fwrite(binary, (size_t)written, 1, file) == 1;
+	if(file) ok = (fclose(file) == 0) && ok;
+	if(!ok) LINCE_INFO(" Failed to write shader cache '%s'", path);
+	free(binary);
+	LINCE_PROFILER_END(timer);
+}
@@ -7,17 +7,39 @@
 
 #include "lince/containers/hashmap.h"
 
+/* Name of the uniform block of per-scene data, see LinceSceneUniforms */
+#define LINCE_SCENE_UNIFORM_BLOCK "LinceScene"
+
+/* Binding point of the per-scene uniform buffer */
+#define LINCE_SCENE_UNIFORM_BINDING 0
+
+/*
+GLSL declaration of the per-scene uniform block, which may be pasted into shader sources.
+Shaders that declare it are bound to the renderer's per-scene data when created.
+*/
+#define LINCE_SCENE_UNIFORM_GLSL \
+	"layout (std140) uniform " LINCE_SCENE_UNIFORM_BLOCK " {\n" \
+	"   mat4 u_view_proj;\n" \
+	"   mat4 u_view_proj_inv;\n" \
+	"   vec2 u_screen_size;\n" \
+	"   float u_time;\n" \
+	"   float u_dt;\n" \
+	"};\n"
 
 typedef struct LinceShader {
 	unsigned int id; // opengl id
 	char name[LINCE_NAME_MAX]; // name, normally based on source file
-	
-	//char **uniform_names; // name in the shader code
-	//int *uniform_ids; // opengl uniform id
-	//unsigned int uniform_count; // length of uniform array
-	hashmap_t uniforms;
+	hashmap_t uniforms; // locations of uniforms by name, filled in when linked
 } LinceShader;
 
+/*
+Sets the directory where linked shader programs are cached, or disables caching if NULL.
+Shaders created from the same sources on the same driver are then loaded
+from their program binary instead of being compiled again.
+Caching is disabled by default, and the app enables it with LinceApp.shader_cache_dir.
+*/
+void LinceSetShaderCacheDir(const char* dir);
+
 /* Create shader from paths to vertex and fragment shader source files */
 LinceShader* LinceCreateShader(
 	const char* name,
@@ -43,9 +65,14 @@ void LinceDeleteShader(LinceShader* shader);
 
 /*
 Uniform functions.
-Ensure a shader is bound before using these functions
+These set the uniforms of the given shader, whether it is bound or not.
+*/
+/*
+Returns OpenGL ID of given uniform name, and -1 if it doesn't exist.
+The locations of active uniforms are cached when the shader is linked.
+The ID may be kept and passed to the `ByID` setters below,
+which skip the lookup by name.
 */
-/* Returns OpenGL ID of given uniform name, and -1 if it doesn't exist */
 int LinceGetShaderUniformID(LinceShader* shader, const char* name);
 
 /* Set integer uniform */
@@ -73,4 +100,17 @@ void LinceSetShaderUniformMat3(LinceShader* sh, const char* name, mat3 m);
 /* Set mat4 uniform */
 void LinceSetShaderUniformMat4(LinceShader* sh, const char* name, mat4 m);
 
+/*
+Uniform setters by ID, as returned by LinceGetShaderUniformID.
+IDs of -1 are ignored.
+*/
+void LinceSetShaderUniformIntByID(LinceShader* sh, int id, int val);
+void LinceSetShaderUniformIntNByID(LinceShader* sh, int id, int* arr, unsigned int count);
+void LinceSetShaderUniformFloatByID(LinceShader* sh, int id, float val);
+void LinceSetShaderUniformVec2ByID(LinceShader* sh, int id, vec2 v);
+void LinceSetShaderUniformVec3ByID(LinceShader* sh, int id, vec3 v);
+void LinceSetShaderUniformVec4ByID(LinceShader* sh, int id, vec4 v);
+void LinceSetShaderUniformMat3ByID(LinceShader* sh, int id, mat3 m);
+void LinceSetShaderUniformMat4ByID(LinceShader* sh, int id, mat4 m);
+
 #endif /* LINCE_SHADER_H */
\ No newline at end of file
@@ -1,8 +1,27 @@
 #include "core/profiler.h"
+#include "core/memory.h"
 #include "renderer/texture.h"
+#include "renderer/renderer.h"
+#include "renderer/block_compression.h"
 #include <stb_image.h>
 #include <glad/glad.h>
 
+LinceBool LinceIsImageOpaque(const unsigned char* data, uint32_t width, uint32_t height){
+	size_t pixels = (size_t)width * height;
+	for(size_t i = 0; i != pixels; ++i){
+		if(data[i*4 + 3] != 0xFF) return LinceFalse;
+	}
+	return LinceTrue;
+}
+
+/* Uploads a mip level built by LinceBuildTextureLevels */
+static LinceBool LinceUploadTextureLevel(void* texture, uint32_t level,
+	const unsigned char* data, size_t size){
+	LINCE_UNUSED(size);
+	LinceSetTextureLevelData(texture, level, data);
+	return LinceTrue;
+}
+
 LinceTexture* LinceLoadTexture(const char* name, const char* path, uint32_t flags){
 	LINCE_PROFILER_START(timer);
 	LINCE_INFO(" Loading texture %s from '%s'", name, path);
@@ -20,8 +39,23 @@ LinceTexture* LinceLoadTexture(const char* name, const char* path, uint32_t flag
 	LINCE_ASSERT(channels == 4,
 		" Error on image '%s'. Only 4-channel RGBA format supported", path);
 	
-	tex = LinceCreateEmptyTexture(name, (uint32_t)(width), (uint32_t)(height));
-	LinceSetTextureData(tex, data);
+	LinceTextureFormat format = LinceGetTextureFlagsFormat(flags);
+	if(!LinceIsTextureFormatSupported(format)){
+		LINCE_INFO(" Texture format %d not supported, loading %s uncompressed", (int)format, name);
+		format = LinceTextureFormat_RGBA8;
+	}
+	uint32_t levels = 1;
+	if(flags & LinceTexture_Mipmaps) levels = LinceGetMipLevelCount((uint32_t)width, (uint32_t)height);
+
+	if(format == LinceTextureFormat_RGBA8 && levels == 1){
+		tex = LinceCreateEmptyTexture(name, (uint32_t)(width), (uint32_t)(height));
+		LinceSetTextureData(tex, data);
+	} else {
+		tex = LinceCreateTextureLevels(name, (uint32_t)width, (uint32_t)height, format, levels);
+		tex->opaque = LinceIsImageOpaque(data, tex->width, tex->height);
+		LinceBuildTextureLevels(data, tex->width, tex->height, format, levels,
+			LinceUploadTextureLevel, tex);
+	}
 	stbi_image_free(data);
 
 	LINCE_INFO(" Loaded %dx%d texture %s", width, height, name);
@@ -42,8 +76,59 @@ LinceTexture* LinceCreateEmptyTexture(
 	const char* name,
 	uint32_t width,
 	uint32_t height
+) {
+	return LinceCreateTextureLevels(name, width, height, LinceTextureFormat_RGBA8, 1);
+}
+
+/* OpenGL formats of block-compressed textures, from EXT_texture_compression_s3tc */
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+/* OpenGL internal format of each LinceTextureFormat */
+static const GLenum texture_internal_formats[LinceTextureFormat_Count] = {
+	[LinceTextureFormat_RGBA8] = GL_RGBA8,
+	[LinceTextureFormat_BC1]   = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+	[LinceTextureFormat_BC3]   = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+	[LinceTextureFormat_BC7]   = GL_COMPRESSED_RGBA_BPTC_UNORM,
+};
+
+/* Returns true if the current context lists an OpenGL extension */
+static LinceBool LinceHasGLExtension(const char* extension){
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for(GLint i = 0; i != count; ++i){
+		const char* name = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+		if(name && strcmp(name, extension) == 0) return LinceTrue;
+	}
+	return LinceFalse;
+}
+
+LinceBool LinceIsTextureFormatSupported(LinceTextureFormat format){
+	// BC7 is core since OpenGL 4.2, BC1 and BC3 remain an extension
+	static int s3tc = -1;
+	if(format != LinceTextureFormat_BC1 && format != LinceTextureFormat_BC3) return LinceTrue;
+	if(s3tc < 0) s3tc = LinceHasGLExtension("GL_EXT_texture_compression_s3tc");
+	return s3tc ? LinceTrue : LinceFalse;
+}
+
+LinceTexture* LinceCreateTextureLevels(
+	const char* name,
+	uint32_t width,
+	uint32_t height,
+	LinceTextureFormat format,
+	uint32_t levels
 ) {
 	LINCE_PROFILER_START(timer);
+	LINCE_ASSERT(format < LinceTextureFormat_Count, " Unknown texture format %d", (int)format);
+	LINCE_ASSERT(LinceIsTextureFormatSupported(format),
+		" Texture format %d not supported by the driver", (int)format);
+	LINCE_ASSERT(levels > 0 && levels <= LinceGetMipLevelCount(width, height),
+		" Invalid number of mip levels %d", (int)levels);
+
 	// allocate texture data
 	LinceTexture *tex = calloc(1, sizeof(LinceTexture));
 	LINCE_ASSERT_ALLOC(tex, sizeof(LinceTexture));
@@ -53,18 +138,22 @@ LinceTexture* LinceCreateEmptyTexture(
 		" Texture name too long: %s", name);
 	memcpy(tex->name, name, strlen(name));
 
-	// default formats - only RGBA supported!!
-	tex->internal_format = GL_RGBA8;
+	// only RGBA data supported!!
+	tex->format = format;
+	tex->levels = levels;
+	tex->internal_format = texture_internal_formats[format];
 	tex->data_format = GL_RGBA;
 
 	// create opengl object
 	glCreateTextures(GL_TEXTURE_2D, 1, &tex->id);
-	glTextureStorage2D(tex->id, 1, tex->internal_format, tex->width, tex->height);
+	glTextureStorage2D(tex->id, levels, tex->internal_format, tex->width, tex->height);
 	
 	// Settings
-	// interpolation by nearest pixel
-	glTextureParameteri(tex->id, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	// interpolation by nearest pixel, blending the two closest mip levels
+	GLint min_filter = levels > 1 ? GL_NEAREST_MIPMAP_LINEAR : GL_NEAREST;
+	glTextureParameteri(tex->id, GL_TEXTURE_MIN_FILTER, min_filter);
 	glTextureParameteri(tex->id, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTextureParameteri(tex->id, GL_TEXTURE_MAX_LEVEL, (GLint)levels - 1);
 	// for geometry larger than texture, repeat texture to fill out
 	glTextureParameteri(tex->id, GL_TEXTURE_WRAP_S, GL_REPEAT);
 	glTextureParameteri(tex->id, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -76,18 +165,124 @@ LinceTexture* LinceCreateEmptyTexture(
 /* Provides custom data to an existing texture buffer */
 void LinceSetTextureData(LinceTexture* texture, unsigned char* data){
 	LINCE_PROFILER_START(timer);
-	glTextureSubImage2D(
-		texture->id,          // OpenGL ID
-		0, 0, 0,              // level, xoffset, yoffset
-		texture->width,       // x size
-		texture->height,      // y size
-		texture->data_format, // e.g. GL_RGBA
-		GL_UNSIGNED_BYTE,     // data type
-		data                  // buffer
-	);
+	LINCE_ASSERT(texture->format == LinceTextureFormat_RGBA8,
+		" Texture %s is compressed, use LinceSetTextureLevelData", texture->name);
+	LinceSetTextureLevelData(texture, 0, data);
+
+	// the renderer draws opaque textures without blending
+	texture->opaque = LinceIsImageOpaque(data, texture->width, texture->height);
 	LINCE_PROFILER_END(timer);
 }
 
+void LinceSetTextureLevelData(LinceTexture* texture, uint32_t level, const unsigned char* data){
+	LINCE_ASSERT(level < texture->levels, " Texture %s has no mip level %d",
+		texture->name, (int)level);
+	uint32_t width = texture->width >> level, height = texture->height >> level;
+	if(width == 0) width = 1;
+	if(height == 0) height = 1;
+
+	if(texture->format == LinceTextureFormat_RGBA8){
+		glTextureSubImage2D(
+			texture->id,          // OpenGL ID
+			(GLint)level, 0, 0,   // level, xoffset, yoffset
+			width,                // x size
+			height,               // y size
+			texture->data_format, // e.g. GL_RGBA
+			GL_UNSIGNED_BYTE,     // data type
+			data                  // buffer
+		);
+	} else {
+		glCompressedTextureSubImage2D(
+			texture->id, (GLint)level, 0, 0, width, height, texture->internal_format,
+			(GLsizei)LinceGetTextureLevelSize(texture->format, width, height), data
+		);
+	}
+}
+
+size_t LinceGetTextureLevelSize(LinceTextureFormat format, uint32_t width, uint32_t height){
+	if(format == LinceTextureFormat_RGBA8) return (size_t)width * height * 4;
+	// whole blocks of 4x4 pixels, even at the edges
+	size_t blocks = (size_t)((width + 3) / 4) * ((height + 3) / 4);
+	return blocks * (format == LinceTextureFormat_BC1 ? 8 : 16);
+}
+
+uint32_t LinceGetMipLevelCount(uint32_t width, uint32_t height){
+	uint32_t size = width > height ? width : height;
+	uint32_t levels = 1;
+	while(size > 1){
+		size >>= 1;
+		levels++;
+	}
+	return levels;
+}
+
+LinceTextureFormat LinceGetTextureFlagsFormat(uint32_t flags){
+	if(flags & LinceTexture_BC7) return LinceTextureFormat_BC7;
+	if(flags & LinceTexture_BC3) return LinceTextureFormat_BC3;
+	if(flags & LinceTexture_BC1) return LinceTextureFormat_BC1;
+	return LinceTextureFormat_RGBA8;
+}
+
+/* Each pixel is written after the pixels it is made from are read, so src may be dst */
+void LinceDownsampleImage(const unsigned char* src, uint32_t width, uint32_t height, unsigned char* dst){
+	uint32_t w = width > 1 ? width / 2 : 1;
+	uint32_t h = height > 1 ? height / 2 : 1;
+	for(uint32_t y = 0; y != h; ++y){
+		// clamped at the edges of odd sizes
+		uint32_t y0 = y * 2, y1 = y0 + 1 < height ? y0 + 1 : y0;
+		for(uint32_t x = 0; x != w; ++x){
+			uint32_t x0 = x * 2, x1 = x0 + 1 < width ? x0 + 1 : x0;
+			for(uint32_t c = 0; c != 4; ++c){
+				uint32_t sum = src[(y0 * width + x0) * 4 + c] + src[(y0 * width + x1) * 4 + c]
+				             + src[(y1 * width + x0) * 4 + c] + src[(y1 * width + x1) * 4 + c];
+				dst[(y * w + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+			}
+		}
+	}
+}
+
+LinceBool LinceBuildTextureLevels(
+	const unsigned char* data, uint32_t width, uint32_t height,
+	LinceTextureFormat format, uint32_t levels,
+	LinceTextureLevelFn fn, void* user_data
+){
+	LINCE_PROFILER_START(timer);
+	LinceBool compressed = format != LinceTextureFormat_RGBA8;
+	size_t pixel_bytes = (size_t)width * height * 4;
+
+	// levels are downsampled in place from a copy of the image
+	unsigned char* image = NULL;
+	if(levels > 1){
+		image = LinceMalloc(pixel_bytes);
+		memcpy(image, data, pixel_bytes);
+	}
+	unsigned char* blocks = compressed ?
+		LinceMalloc(LinceGetTextureLevelSize(format, width, height)) : NULL;
+
+	LinceBool ok = LinceTrue;
+	const unsigned char* level = data;
+	uint32_t w = width, h = height;
+	for(uint32_t i = 0; i != levels && ok; ++i){
+		if(i > 0){
+			LinceDownsampleImage(image, w, h, image);
+			w = w > 1 ? w / 2 : 1;
+			h = h > 1 ? h / 2 : 1;
+			level = image;
+		}
+		size_t size = LinceGetTextureLevelSize(format, w, h);
+		if(compressed){
+			LinceCompressImage(format, level, w, h, blocks);
+			ok = fn(user_data, i, blocks, size);
+		} else {
+			ok = fn(user_data, i, level, size);
+		}
+	}
+	LinceFree(image);
+	LinceFree(blocks);
+	LINCE_PROFILER_END(timer);
+	return ok;
+}
+
 /* Deallocates texture memory and destroys OpenGL texture object */
 void LinceDeleteTexture(LinceTexture* texture){
 	if(!texture) return;
@@ -105,4 +300,215 @@ void LinceBindTexture(LinceTexture* texture, uint32_t slot){
 	Note: don't do 'GL_TEXTURE0 + slot' on glBindTextureUnit,
 		rather pass slot value directly.
 	*/
-}
\ No newline at end of file
+}
+
+
+
+/* Texture loads in progress, oldest first. Only used by the rendering thread */
+static LinceTextureLoad* pending_loads = NULL;
+
+/* Decodes the image of a texture load, on a worker thread */
+static void LinceDecodeTextureLoad(void* data){
+	LinceTextureLoad* load = data;
+
+	// the flip setting of other threads is left untouched
+	stbi_set_flip_vertically_on_load_thread(load->flags & LinceTexture_FlipY);
+	int width = 0, height = 0, channels = 0;
+	load->data = stbi_load(load->path, &width, &height, &channels, 4);
+	if(!load->data) return;
+	if(width <= 0 || height <= 0){
+		stbi_image_free(load->data);
+		load->data = NULL;
+		return;
+	}
+	load->width = (uint32_t)width;
+	load->height = (uint32_t)height;
+	load->opaque = LinceIsImageOpaque(load->data, load->width, load->height);
+}
+
+/*
+Moves a texture load forward, uploading rows of pixels from the budget.
+Returns true once the load has finished or failed.
+*/
+static LinceBool LinceStepTextureLoad(LinceTextureLoad* load, size_t* budget){
+	if(load->state == LinceTextureLoad_Decoding){
+		if(!LinceIsCounterZero(&load->counter)) return LinceFalse;
+		if(!load->data){
+			LINCE_INFO(" Failed to load texture '%s'", load->path);
+			load->state = LinceTextureLoad_Failed;
+			return LinceTrue;
+		}
+		uint32_t levels = 1;
+		if(load->flags & LinceTexture_Mipmaps) levels = LinceGetMipLevelCount(load->width, load->height);
+		load->texture = LinceCreateTextureLevels(load->name, load->width, load->height,
+			LinceTextureFormat_RGBA8, levels);
+		glCreateBuffers(1, &load->pbo);
+		glNamedBufferData(load->pbo, (size_t)load->width * load->height * 4, NULL, GL_STREAM_DRAW);
+		load->state = LinceTextureLoad_Uploading;
+	}
+	if(*budget == 0) return LinceFalse;
+
+	// at least one row, so that large images always make progress
+	size_t row_bytes = (size_t)load->width * 4;
+	size_t rows = *budget / row_bytes;
+	if(rows == 0) rows = 1;
+	if(rows > load->height - load->rows_uploaded) rows = load->height - load->rows_uploaded;
+	size_t offset = load->rows_uploaded * row_bytes;
+	size_t size = rows * row_bytes;
+
+	// this range of the buffer has not been used by the GPU yet
+	void* dest = glMapNamedBufferRange(load->pbo, offset, size,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	memcpy(dest, load->data + offset, size);
+	glUnmapNamedBuffer(load->pbo);
+
+	// copied from the bound buffer, without stalling on the transfer
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, load->pbo);
+	glTextureSubImage2D(
+		load->texture->id, 0,
+		0, (GLint)load->rows_uploaded, (GLsizei)load->width, (GLsizei)rows,
+		load->texture->data_format, GL_UNSIGNED_BYTE, (const void*)(uintptr_t)offset
+	);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	load->rows_uploaded += (uint32_t)rows;
+	*budget -= size < *budget ? size : *budget;
+
+	if(load->rows_uploaded < load->height) return LinceFalse;
+
+	load->texture->opaque = load->opaque;
+	if(load->texture->levels > 1) glGenerateTextureMipmap(load->texture->id);
+	glDeleteBuffers(1, &load->pbo);
+	load->pbo = 0;
+	stbi_image_free(load->data);
+	load->data = NULL;
+	load->state = LinceTextureLoad_Ready;
+	LINCE_INFO(" Loaded %dx%d texture %s", (int)load->width, (int)load->height, load->name);
+	return LinceTrue;
+}
+
+LinceTextureLoad* LinceLoadTextureAsync(
+	LinceJobSystem* jobs, const char* name, const char* path, uint32_t flags
+){
+	LINCE_ASSERT(strlen(name) < LINCE_NAME_MAX, " Texture name too long: %s", name);
+	LINCE_ASSERT(strlen(path) < LINCE_STR_MAX, " Texture path too long: %s", path);
+	LINCE_INFO(" Loading texture %s from '%s' in the background", name, path);
+
+	LinceTextureLoad* load = LinceCalloc(sizeof(LinceTextureLoad));
+	memcpy(load->name, name, strlen(name));
+	memcpy(load->path, path, strlen(path));
+	load->flags = flags;
+	load->jobs = jobs;
+	load->state = LinceTextureLoad_Decoding;
+
+	// without worker threads, nothing would pick up the job between frames
+	if(jobs && LinceGetJobThreadCount(jobs) > 1){
+		LinceRunJob(jobs, LinceDecodeTextureLoad, load, &load->counter);
+	} else {
+		LinceDecodeTextureLoad(load);
+	}
+
+	// appended, so that textures are uploaded in the order they were requested
+	LinceTextureLoad** link = &pending_loads;
+	while(*link) link = &(*link)->next;
+	*link = load;
+	return load;
+}
+
+LinceBool LinceIsTextureReady(LinceTextureLoad* load){
+	return load->state == LinceTextureLoad_Ready;
+}
+
+LinceTexture* LinceGetLoadedTexture(LinceTextureLoad* load){
+	return load->state == LinceTextureLoad_Ready ? load->texture : LinceGetWhiteTexture();
+}
+
+void LinceUpdateTextureLoads(size_t max_bytes){
+	if(!pending_loads) return;
+	LINCE_PROFILER_START(timer);
+
+	LinceTextureLoad** link = &pending_loads;
+	while(*link){
+		LinceTextureLoad* load = *link;
+		if(LinceStepTextureLoad(load, &max_bytes)){
+			*link = load->next;
+			load->next = NULL;
+		} else {
+			link = &load->next;
+		}
+	}
+	LINCE_PROFILER_END(timer);
+}
+
+void LinceDeleteTextureLoad(LinceTextureLoad* load){
+	if(!load) return;
+	if(load->state == LinceTextureLoad_Decoding && load->jobs){
+		LinceWaitForCounter(load->jobs, &load->counter);
+	}
+
+	// unfinished loads are still in the list
+	LinceTextureLoad** link = &pending_loads;
+	while(*link && *link != load) link = &(*link)->next;
+	if(*link) *link = load->next;
+
+	if(load->state != LinceTextureLoad_Ready) LinceDeleteTexture(load->texture);
+	if(load->pbo) glDeleteBuffers(1, &load->pbo);
+	if(load->data) stbi_image_free(load->data);
+	LinceFree(load);
+}
+
+LinceTexturePool* LinceCreateTexturePool(uint32_t width, uint32_t height, uint32_t layers){
+	LINCE_PROFILER_START(timer);
+	LINCE_INFO(" Creating texture pool of %d %dx%d layers",
+		(int)layers, (int)width, (int)height);
+
+	LinceTexturePool* pool = calloc(1, sizeof(LinceTexturePool));
+	LINCE_ASSERT_ALLOC(pool, sizeof(LinceTexturePool));
+	pool->width = width;
+	pool->height = height;
+	pool->layers = layers;
+	pool->internal_format = GL_RGBA8;
+
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &pool->id);
+	glTextureStorage3D(pool->id, 1, pool->internal_format, width, height, layers);
+
+	// same settings as 2D textures
+	glTextureParameteri(pool->id, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTextureParameteri(pool->id, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTextureParameteri(pool->id, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTextureParameteri(pool->id, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	LINCE_PROFILER_END(timer);
+	return pool;
+}
+
+LinceBool LinceAddTextureToPool(LinceTexturePool* pool, LinceTexture* texture){
+	LINCE_ASSERT(pool && texture, "Texture pool or texture missing");
+	if(texture->pool) return texture->pool == pool;
+	if(pool->count >= pool->layers) return LinceFalse;
+	// layers have no mip levels of their own
+	if(texture->levels != 1) return LinceFalse;
+	if(texture->width != pool->width || texture->height != pool->height){
+		return LinceFalse;
+	}
+	if(texture->internal_format != pool->internal_format) return LinceFalse;
+
+	// copy on the GPU, without reading back the texture
+	glCopyImageSubData(
+		texture->id, GL_TEXTURE_2D, 0, 0, 0, 0,
+		pool->id, GL_TEXTURE_2D_ARRAY, 0, 0, 0, (GLint)pool->count,
+		texture->width, texture->height, 1
+	);
+	texture->pool = pool;
+	texture->layer = pool->count++;
+	return LinceTrue;
+}
+
+void LinceBindTexturePool(LinceTexturePool* pool, uint32_t slot){
+	glBindTextureUnit(slot, pool->id);
+}
+
+void LinceDeleteTexturePool(LinceTexturePool* pool){
+	if(!pool) return;
+	glDeleteTextures(1, &pool->id);
+	free(pool);
+}
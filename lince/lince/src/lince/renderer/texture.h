@@ -2,22 +2,91 @@
 #define LINCE_TEXTURE_H
 
 #include "lince/core/core.h"
+#include "lince/core/jobs.h"
+
+// Max bytes of texture data uploaded per frame by LinceUpdateTextureLoads
+#ifndef LINCE_TEXTURE_UPLOAD_BUDGET
+#define LINCE_TEXTURE_UPLOAD_BUDGET (4 * 1024 * 1024)
+#endif
 
 typedef enum LinceTextureFlags {
 	LinceTexture_Default = 0x0,
 	LinceTexture_FlipY = 0x1,   // flips texture vertically on load
+	LinceTexture_Mipmaps = 0x2, // stores a chain of mip levels, each half the size of the last
+	LinceTexture_BC1 = 0x4,     // compresses to BC1 on the CPU, 1-bit alpha
+	LinceTexture_BC3 = 0x8,     // compresses to BC3 on the CPU
+	LinceTexture_BC7 = 0x10,    // compresses to BC7 on the CPU
 	// LinceTexture_DropAlpha, // 
 	// LinceTexture_ForceAlpha // allows to load RGB format but adds alpha of 1
 } LinceTextureFlags;
 
+/* Layout of the pixel data of a texture */
+typedef enum LinceTextureFormat {
+	LinceTextureFormat_RGBA8, // 4 bytes per pixel
+	LinceTextureFormat_BC1,   // 8 bytes per block of 4x4 pixels, with 1-bit alpha
+	LinceTextureFormat_BC3,   // 16 bytes per block of 4x4 pixels
+	LinceTextureFormat_BC7,   // 16 bytes per block of 4x4 pixels, higher quality than BC3
+	LinceTextureFormat_Count
+} LinceTextureFormat;
+
+typedef struct LinceTexturePool LinceTexturePool;
+
 typedef struct LinceTexture {
 	uint32_t id;               // OpenGL ID
 	uint32_t width, height;    // dimension of 2D texture
 	char name[LINCE_NAME_MAX]; // unique string identifier
 	int32_t data_format;     // format of texture file, e.g. RGBA
 	int32_t internal_format; // format of data in OpenGL buffer
+	LinceTextureFormat format; // layout of pixel data
+	uint32_t levels;         // number of mip levels
+	LinceTexturePool* pool;  // pool holding a copy of the texture, or NULL
+	uint32_t layer;          // layer of the texture in its pool
+	LinceBool opaque;        // all pixels have full alpha, set by LinceSetTextureData
 } LinceTexture;
 
+/*
+Array texture whose layers hold copies of textures of the same size.
+The renderer draws all textures in a pool with a single binding,
+so that they do not take up a texture slot each.
+*/
+typedef struct LinceTexturePool {
+	uint32_t id;            // OpenGL ID
+	uint32_t width, height; // dimension of each layer
+	uint32_t layers;        // max number of textures
+	uint32_t count;         // number of textures added
+	int32_t internal_format;
+} LinceTexturePool;
+
+typedef enum LinceTextureLoadState {
+	LinceTextureLoad_Decoding,  // image being decoded on a worker thread
+	LinceTextureLoad_Uploading, // pixel data being copied to the GPU over several frames
+	LinceTextureLoad_Ready,     // texture may be drawn
+	LinceTextureLoad_Failed     // image could not be loaded
+} LinceTextureLoadState;
+
+/*
+Texture loaded in the background, see LinceLoadTextureAsync.
+The image is decoded on a worker thread, and its pixels are uploaded
+through a pixel buffer a few rows at a time on the following frames.
+*/
+typedef struct LinceTextureLoad {
+	LinceTexture* texture;       // loaded texture, complete once the state is ready
+	LinceTextureLoadState state;
+	char name[LINCE_NAME_MAX];
+	char path[LINCE_STR_MAX];
+	uint32_t flags;
+
+	// internal
+	LinceJobSystem* jobs;
+	LinceJobCounter counter;      // zero once decoded
+	unsigned char* data;          // decoded RGBA pixels
+	uint32_t width, height;
+	LinceBool opaque;
+	uint32_t rows_uploaded;
+	uint32_t pbo;                 // pixel unpack buffer, OpenGL ID
+	struct LinceTextureLoad* next; // next load in progress
+} LinceTextureLoad;
+
 /* Loads a texture from a filename */
 LinceTexture* LinceLoadTexture(const char* name, const char* path, uint32_t flags);
 
@@ -28,9 +97,59 @@ LinceTexture* LinceCreateTexture(const char* name, const char* path);
 LinceTexture* LinceCreateEmptyTexture(const char* name, 
 	uint32_t width, uint32_t height);
 
-/* Provides custom data to an existing texture buffer */
+/*
+Creates an empty texture with the given pixel format and number of mip levels.
+Textures with more than one level are sampled from smaller levels when zoomed out.
+*/
+LinceTexture* LinceCreateTextureLevels(const char* name, uint32_t width, uint32_t height,
+	LinceTextureFormat format, uint32_t levels);
+
+/* Provides custom data to an existing texture buffer,
+and checks whether it is fully opaque */
 void LinceSetTextureData(LinceTexture* texture, unsigned char* data);
 
+/* Provides the data of one mip level, laid out in the format of the texture */
+void LinceSetTextureLevelData(LinceTexture* texture, uint32_t level, const unsigned char* data);
+
+/* Returns the number of bytes of one level of the given size and format */
+size_t LinceGetTextureLevelSize(LinceTextureFormat format, uint32_t width, uint32_t height);
+
+/* Returns the number of levels of a full mip chain, down to 1x1 pixels */
+uint32_t LinceGetMipLevelCount(uint32_t width, uint32_t height);
+
+/*
+Returns true if the driver can sample textures of the given format.
+BC1 and BC3 need GL_EXT_texture_compression_s3tc, which some drivers lack.
+*/
+LinceBool LinceIsTextureFormatSupported(LinceTextureFormat format);
+
+/* Returns the format selected by compression flags, or RGBA8 if none */
+LinceTextureFormat LinceGetTextureFlagsFormat(uint32_t flags);
+
+/* Returns true if all pixels of RGBA data of size (w,h) have full alpha */
+LinceBool LinceIsImageOpaque(const unsigned char* data, uint32_t width, uint32_t height);
+
+/*
+Halves RGBA pixel data of size (w,h) by averaging blocks of 2x2 pixels.
+May be done in place.
+*/
+void LinceDownsampleImage(const unsigned char* src, uint32_t width, uint32_t height, unsigned char* dst);
+
+/* Receives the data of each mip level built by LinceBuildTextureLevels */
+typedef LinceBool (*LinceTextureLevelFn)(void* user_data, uint32_t level,
+	const unsigned char* data, size_t size);
+
+/*
+Builds `levels` mip levels from RGBA pixel data of size (w,h), each one downsampled
+from the last and compressed to `format`, and passes them in order to a callback.
+Stops and returns false if the callback does.
+*/
+LinceBool LinceBuildTextureLevels(
+	const unsigned char* data, uint32_t width, uint32_t height,
+	LinceTextureFormat format, uint32_t levels,
+	LinceTextureLevelFn fn, void* user_data
+);
+
 /* Deallocates texture memory and destroys OpenGL texture object */
 void LinceDeleteTexture(LinceTexture* texture);
 
@@ -39,4 +158,50 @@ void LinceBindTexture(LinceTexture* texture, uint32_t slot);
 
 // void LinceUnbindTexture(); // not necessary
 
+/*
+Starts loading a texture in the background and returns immediately.
+The image is decoded on a worker thread of the job system,
+or on the calling thread if it is NULL or has no workers,
+and uploaded by LinceUpdateTextureLoads, which the app calls every frame.
+Must be called from the rendering thread.
+*/
+LinceTextureLoad* LinceLoadTextureAsync(
+	LinceJobSystem* jobs, const char* name, const char* path, uint32_t flags
+);
+
+/* Returns true once a texture load has finished and the texture can be drawn */
+LinceBool LinceIsTextureReady(LinceTextureLoad* load);
+
+/* Returns the loaded texture, or the renderer's white texture until it is ready */
+LinceTexture* LinceGetLoadedTexture(LinceTextureLoad* load);
+
+/*
+Advances texture loads in progress, uploading up to `max_bytes` of pixel data.
+Called by the app on every frame, from the rendering thread.
+*/
+void LinceUpdateTextureLoads(size_t max_bytes);
+
+/*
+Cancels a texture load if still in progress, and frees it.
+A texture that finished loading is kept, and must be deleted with LinceDeleteTexture.
+*/
+void LinceDeleteTextureLoad(LinceTextureLoad* load);
+
+/* Creates a texture pool for up to `layers` textures of the given dimensions */
+LinceTexturePool* LinceCreateTexturePool(uint32_t width, uint32_t height, uint32_t layers);
+
+/*
+Copies a texture into the next free layer of a pool.
+The texture must have the same size and format as the pool and a single mip level,
+and is then drawn from the pool.
+Returns false if the texture does not fit.
+*/
+LinceBool LinceAddTextureToPool(LinceTexturePool* pool, LinceTexture* texture);
+
+/* Binds the array texture of a pool to a slot */
+void LinceBindTexturePool(LinceTexturePool* pool, uint32_t slot);
+
+/* Destroys the array texture of a pool. Its textures must not be drawn afterwards */
+void LinceDeleteTexturePool(LinceTexturePool* pool);
+
 #endif /* LINCE_TEXTURE_H */
\ No newline at end of file
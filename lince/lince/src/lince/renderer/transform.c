@@ -0,0 +1,71 @@
+#include "renderer/transform.h"
+#include <math.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#   define LINCE_TRANSFORM_SSE
+#   include <xmmintrin.h>
+#endif
+
+#define LINCE_DEG_TO_RAD 0.017453292519943295f
+
+/* Corners of a quad of size 1x1 centred on 0,0 */
+static const float quad_corners_x[4] = {-0.5f,  0.5f, 0.5f, -0.5f};
+static const float quad_corners_y[4] = {-0.5f, -0.5f, 0.5f,  0.5f};
+
+#ifdef LINCE_TRANSFORM_SSE
+
+void LinceTransformQuad(
+    float x, float y,
+    float w, float h,
+    float rotation,
+    float xs[4], float ys[4]
+){
+    // scaled corners, one per lane
+    __m128 lx = _mm_mul_ps(_mm_loadu_ps(quad_corners_x), _mm_set1_ps(w));
+    __m128 ly = _mm_mul_ps(_mm_loadu_ps(quad_corners_y), _mm_set1_ps(h));
+
+    if(rotation == 0.0f){
+        _mm_storeu_ps(xs, _mm_add_ps(lx, _mm_set1_ps(x)));
+        _mm_storeu_ps(ys, _mm_add_ps(ly, _mm_set1_ps(y)));
+        return;
+    }
+
+    // clockwise rotation:
+    // x' = x cos + y sin
+    // y' = y cos - x sin
+    const float rad = rotation * LINCE_DEG_TO_RAD;
+    const __m128 c = _mm_set1_ps(cosf(rad));
+    const __m128 s = _mm_set1_ps(sinf(rad));
+    __m128 rx = _mm_add_ps(_mm_mul_ps(lx, c), _mm_mul_ps(ly, s));
+    __m128 ry = _mm_sub_ps(_mm_mul_ps(ly, c), _mm_mul_ps(lx, s));
+    _mm_storeu_ps(xs, _mm_add_ps(rx, _mm_set1_ps(x)));
+    _mm_storeu_ps(ys, _mm_add_ps(ry, _mm_set1_ps(y)));
+}
+
+#else
+
+void LinceTransformQuad(
+    float x, float y,
+    float w, float h,
+    float rotation,
+    float xs[4], float ys[4]
+){
+    if(rotation == 0.0f){
+        for(int i = 0; i != 4; ++i){
+            xs[i] = quad_corners_x[i] * w + x;
+            ys[i] = quad_corners_y[i] * h + y;
+        }
+        return;
+    }
+
+    const float rad = rotation * LINCE_DEG_TO_RAD;
+    const float c = cosf(rad), s = sinf(rad);
+    for(int i = 0; i != 4; ++i){
+        float lx = quad_corners_x[i] * w;
+        float ly = quad_corners_y[i] * h;
+        xs[i] = lx * c + ly * s + x;
+        ys[i] = ly * c - lx * s + y;
+    }
+}
+
+#endif /* LINCE_TRANSFORM_SSE */
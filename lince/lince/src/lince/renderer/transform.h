@@ -0,0 +1,27 @@
+#ifndef LINCE_TRANSFORM_H
+#define LINCE_TRANSFORM_H
+
+#include "lince/core/core.h"
+
+/*
+Calculates the world coordinates of the four corners of a quad,
+in the order lower left, lower right, upper right, upper left
+(before rotation), which is the order of the renderer's quad vertices.
+    - `float x, y`: position of the centre of the quad
+    - `float w, h`: width and height
+    - `float rotation`: clockwise rotation in degrees
+    - `float xs[4], ys[4]`: output coordinates of the corners
+
+This is a 2D affine transform equivalent to applying
+translation, rotation, and scaling matrices to a unit quad,
+and uses SSE where available. Quads with no rotation skip
+the trigonometry altogether.
+*/
+void LinceTransformQuad(
+    float x, float y,
+    float w, float h,
+    float rotation,
+    float xs[4], float ys[4]
+);
+
+#endif /* LINCE_TRANSFORM_H */
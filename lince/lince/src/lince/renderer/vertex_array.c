@@ -29,12 +29,14 @@ void LinceUnbindVertexArray(void){
 	glBindVertexArray(0);
 }
 
-/* Sets up vertex buffer attributes on the vertex array */
-void LinceAddVertexArrayAttributes(
+/* Sets up vertex buffer attributes that advance every `divisor` instances,
+or every vertex if zero */
+static void LinceSetupVertexArrayAttributes(
 	LinceVertexArray* va,
 	LinceVertexBuffer vb,
 	LinceBufferElement* layout,
-	unsigned int layout_elements
+	unsigned int layout_elements,
+	unsigned int divisor
 ){
 	LINCE_PROFILER_START(timer);
 
@@ -59,23 +61,35 @@ void LinceAddVertexArrayAttributes(
 	);
 	for(i=0; i != layout_elements; ++i){
 		LINCE_INFO("   %-10s: %-5d %-5d %-5d",
-			layout[i].name,
+			layout[i].name[0] ? layout[i].name : "(padding)",
 			(int)layout[i].bytes,
 			(int)layout[i].comps,
 			(int)layout[i].offset
 		);
 	}
 
-	// Set vertex attributes
+	// Set vertex attributes, numbered in order skipping padding
+	unsigned int location = 0;
 	for(i = 0; i != layout_elements; ++i){
-		glEnableVertexAttribArray(i);
+		if(layout[i].name[0] == '\0') continue; // padding only takes up space
+		unsigned int index = location++;
+		glEnableVertexAttribArray(index);
+		glVertexAttribDivisor(index, divisor);
+		const void* offset = (const void*)(const uintptr_t)(layout[i].offset);
+		GLenum type = layout[i].gl_type;
+
+		// integer data not normalised is read as integers by the shader
+		if(type != GL_FLOAT && type != GL_HALF_FLOAT && !layout[i].norm){
+			glVertexAttribIPointer(index, layout[i].comps, type, stride, offset);
+			continue;
+		}
 		glVertexAttribPointer(
-			i,
+			index,
 			layout[i].comps, // number of components
-			layout[i].gl_type, // OpenGL type
-			GL_FALSE, // element.norm ? GL_TRUE : GL_FALSE,
+			type, // OpenGL type
+			layout[i].norm ? GL_TRUE : GL_FALSE,
 			stride,
-			(const void*)(const uintptr_t)(layout[i].offset)
+			offset
 		);
 	}
 
@@ -88,6 +102,26 @@ void LinceAddVertexArrayAttributes(
 	LINCE_PROFILER_END(timer);
 }
 
+/* Sets up vertex buffer attributes on the vertex array */
+void LinceAddVertexArrayAttributes(
+	LinceVertexArray* va,
+	LinceVertexBuffer vb,
+	LinceBufferElement* layout,
+	unsigned int layout_elements
+){
+	LinceSetupVertexArrayAttributes(va, vb, layout, layout_elements, 0);
+}
+
+/* Sets up per-instance vertex buffer attributes on the vertex array */
+void LinceAddVertexArrayInstanceAttributes(
+	LinceVertexArray* va,
+	LinceVertexBuffer vb,
+	LinceBufferElement* layout,
+	unsigned int layout_elements
+){
+	LinceSetupVertexArrayAttributes(va, vb, layout, layout_elements, 1);
+}
+
 void LinceDeleteVertexArray(LinceVertexArray* va){
 	LINCE_INFO(" Deleting Vertex Array ");
 	if (!va) return;
@@ -22,10 +22,21 @@ void LinceAddVertexArrayAttributes(
 	LinceVertexArray* vertex_array,  /* must have been initialised already */
 	LinceVertexBuffer vertex_buffer, /* stores raw vertex data */
 	LinceBufferElement* layout,      /* list of buffer elements that 
-								        together constitute the data layout */
+								        together constitute the data layout.
+								        Elements with an empty name are padding:
+								        they take up space but are not attributes */
 	unsigned int layout_elements     /* Number of buffer elements */
 );
 
+/* Same as LinceAddVertexArrayAttributes, but the attributes
+advance once per instance instead of once per vertex */
+void LinceAddVertexArrayInstanceAttributes(
+	LinceVertexArray* vertex_array,
+	LinceVertexBuffer vertex_buffer,
+	LinceBufferElement* layout,
+	unsigned int layout_elements
+);
+
 void LinceDeleteVertexArray(LinceVertexArray* vertex_array);
 
 
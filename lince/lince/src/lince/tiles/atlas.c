@@ -0,0 +1,125 @@
+#include "core/profiler.h"
+#include "core/memory.h"
+#include "tiles/atlas.h"
+#include <stb_image.h>
+#include <glad/glad.h>
+
+LinceAtlas* LinceCreateAtlas(uint32_t width, uint32_t height){
+	LINCE_ASSERT(width > 0 && height > 0, "Atlas pages cannot be empty");
+	LinceAtlas* atlas = LinceCalloc(sizeof(LinceAtlas));
+	atlas->width = width;
+	atlas->height = height;
+	atlas->pages = array_create(sizeof(LinceAtlasPage));
+	return atlas;
+}
+
+LinceBool LincePackAtlasShelves(
+	array_t* shelves, uint32_t page_width, uint32_t page_height,
+	uint32_t w, uint32_t h, uint32_t* x, uint32_t* y
+){
+	const uint32_t pw = w + 2 * LINCE_ATLAS_PADDING;
+	const uint32_t ph = h + 2 * LINCE_ATLAS_PADDING;
+	if(pw > page_width || ph > page_height) return LinceFalse;
+
+	// pick the lowest shelf the image fits in, to waste the least height
+	LinceAtlasShelf* best = NULL;
+	for(uint32_t i = 0; i != shelves->size; ++i){
+		LinceAtlasShelf* shelf = array_get(shelves, i);
+		if(shelf->height < ph || page_width - shelf->width < pw) continue;
+		if(!best || shelf->height < best->height) best = shelf;
+	}
+
+	// otherwise open a new shelf above the others
+	if(!best){
+		uint32_t top = 0;
+		if(shelves->size > 0){
+			LinceAtlasShelf* last = array_back(shelves);
+			top = last->y + last->height;
+		}
+		if(page_height - top < ph) return LinceFalse;
+		array_push_back(shelves, &(LinceAtlasShelf){.y = top, .height = ph, .width = 0});
+		best = array_back(shelves);
+	}
+
+	*x = best->width + LINCE_ATLAS_PADDING;
+	*y = best->y + LINCE_ATLAS_PADDING;
+	best->width += pw;
+	return LinceTrue;
+}
+
+/* Appends an empty page to an atlas */
+static LinceAtlasPage* LinceAddAtlasPage(LinceAtlas* atlas){
+	LinceAtlasPage page = {
+		.texture = LinceCreateEmptyTexture("AtlasPage", atlas->width, atlas->height),
+		.shelves = array_create(sizeof(LinceAtlasShelf))
+	};
+	// padding between images stays transparent
+	glClearTexImage(page.texture->id, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	array_push_back(&atlas->pages, &page);
+	return array_back(&atlas->pages);
+}
+
+LinceTile LinceAddAtlasImage(LinceAtlas* atlas, const unsigned char* data, uint32_t w, uint32_t h){
+	LINCE_PROFILER_START(timer);
+	LINCE_ASSERT(atlas && data, "Atlas or image data missing");
+	LINCE_ASSERT(w + 2*LINCE_ATLAS_PADDING <= atlas->width &&
+		h + 2*LINCE_ATLAS_PADDING <= atlas->height,
+		"Image of %dx%d pixels larger than atlas pages of %dx%d",
+		(int)w, (int)h, (int)atlas->width, (int)atlas->height);
+
+	// try existing pages first, from the last one
+	LinceAtlasPage* page = NULL;
+	uint32_t x = 0, y = 0;
+	for(uint32_t i = atlas->pages.size; i != 0; --i){
+		LinceAtlasPage* p = array_get(&atlas->pages, i - 1);
+		if(LincePackAtlasShelves(&p->shelves, atlas->width, atlas->height, w, h, &x, &y)){
+			page = p;
+			break;
+		}
+	}
+	if(!page){
+		page = LinceAddAtlasPage(atlas);
+		LincePackAtlasShelves(&page->shelves, atlas->width, atlas->height, w, h, &x, &y);
+	}
+
+	glTextureSubImage2D(
+		page->texture->id, 0, (GLint)x, (GLint)y, (GLsizei)w, (GLsizei)h,
+		page->texture->data_format, GL_UNSIGNED_BYTE, data
+	);
+
+	// one cell the size of the image, placed at (x,y) pixels
+	LinceTile tile = LinceGetTile(
+		page->texture,
+		(vec2){(float)x / (float)w, (float)y / (float)h},
+		(vec2){(float)w, (float)h},
+		(vec2){1, 1}
+	);
+	LINCE_PROFILER_END(timer);
+	return tile;
+}
+
+LinceTile LinceLoadAtlasImage(LinceAtlas* atlas, const char* path, uint32_t flags){
+	LINCE_INFO(" Loading '%s' into atlas", path);
+
+	// sets buffer to store data starting from image top-left
+	stbi_set_flip_vertically_on_load(flags & LinceTexture_FlipY);
+	int width = 0, height = 0, channels = 0;
+	unsigned char* data = stbi_load(path, &width, &height, &channels, 4);
+	LINCE_ASSERT(data, " Failed to load image '%s'", path);
+	LINCE_ASSERT((width > 0) && (height > 0), " Empty image '%s'", path);
+
+	LinceTile tile = LinceAddAtlasImage(atlas, data, (uint32_t)width, (uint32_t)height);
+	stbi_image_free(data);
+	return tile;
+}
+
+void LinceDeleteAtlas(LinceAtlas* atlas){
+	if(!atlas) return;
+	for(uint32_t i = 0; i != atlas->pages.size; ++i){
+		LinceAtlasPage* page = array_get(&atlas->pages, i);
+		LinceDeleteTexture(page->texture);
+		array_destroy(&page->shelves);
+	}
+	array_destroy(&atlas->pages);
+	LinceFree(atlas);
+}
@@ -0,0 +1,63 @@
+#ifndef LINCE_ATLAS_H
+#define LINCE_ATLAS_H
+
+#include "lince/tiles/tileset.h"
+#include "lince/containers/array.h"
+
+// Empty pixels left around each image so that neighbours do not bleed into each other
+#ifndef LINCE_ATLAS_PADDING
+#define LINCE_ATLAS_PADDING 1
+#endif
+
+/* Row of images of similar height, see LinceAtlasPage */
+typedef struct LinceAtlasShelf {
+	uint32_t y;      // bottom edge in pixels
+	uint32_t height; // height in pixels
+	uint32_t width;  // pixels taken up from the left
+} LinceAtlasShelf;
+
+/*
+One texture of an atlas.
+Images are packed on shelves stacked from the bottom up.
+*/
+typedef struct LinceAtlasPage {
+	LinceTexture* texture;
+	array_t shelves; // array of LinceAtlasShelf
+} LinceAtlasPage;
+
+/*
+Packs many images into one or a few large textures (pages),
+so that they can be drawn without using a texture slot each.
+Images may be added at any time, and a new page is created when they do not fit.
+*/
+typedef struct LinceAtlas {
+	uint32_t width, height; // size of each page in pixels
+	array_t pages;          // array of LinceAtlasPage
+} LinceAtlas;
+
+/* Creates an empty atlas whose pages have the given size in pixels */
+LinceAtlas* LinceCreateAtlas(uint32_t width, uint32_t height);
+
+/*
+Finds room for an image of size (w,h) on one of the shelves of a page,
+opening a new shelf if needed. Stores its lower left corner in `x`,`y`.
+Returns false if it does not fit. Does not upload any data.
+*/
+LinceBool LincePackAtlasShelves(
+	array_t* shelves, uint32_t page_width, uint32_t page_height,
+	uint32_t w, uint32_t h, uint32_t* x, uint32_t* y
+);
+
+/*
+Copies RGBA pixel data of size (w,h) into the atlas, with rows from the bottom up.
+Returns a tile that covers the image, which may be drawn with LinceDrawQuad(.tile=...).
+*/
+LinceTile LinceAddAtlasImage(LinceAtlas* atlas, const unsigned char* data, uint32_t w, uint32_t h);
+
+/* Loads an image from a file and adds it to the atlas. See LinceLoadTexture for flags */
+LinceTile LinceLoadAtlasImage(LinceAtlas* atlas, const char* path, uint32_t flags);
+
+/* Deletes an atlas and its textures. Tiles taken from it are no longer valid */
+void LinceDeleteAtlas(LinceAtlas* atlas);
+
+#endif /* LINCE_ATLAS_H */
@@ -3,6 +3,11 @@
 #include "lince/core/memory.h"
 #include "lince/tiles/tilemap.h"
 #include "lince/renderer/renderer.h"
+#include "cglm/affine.h"
+#include <math.h>
+
+static void LinceCreateTilemapChunks(LinceTilemap* tm);
+static void LinceDeleteTilemapChunks(LinceTilemap* tm);
 
 LinceTilemap* LinceCreateTilemap(LinceTilemap* props){
     // BEWARE: tileset is not copied!!
@@ -49,6 +54,8 @@ LinceTilemap* LinceCreateTilemap(LinceTilemap* props){
         tm->logic_grid = LinceCalloc(sizeof(uint8_t) * tm_size);
     }
 
+    LinceCreateTilemapChunks(tm);
+
     // Copy overlay tiles
     if(!props->overlay_positions ||
        !props->overlay_tiles ||
@@ -72,6 +79,7 @@ LinceTilemap* LinceCreateTilemap(LinceTilemap* props){
 
 void LinceDeleteTilemap(LinceTilemap* tm){
     if(!tm) return;
+    LinceDeleteTilemapChunks(tm);
     LinceFree(tm->base_grid);
     LinceFree(tm->logic_grid);
     if(tm->bkg_grid) LinceFree(tm->bkg_grid);
@@ -81,27 +89,155 @@ void LinceDeleteTilemap(LinceTilemap* tm){
 }
 
 
-static void LinceDrawTilemapGrids(LinceTilemap* tm){
-    // Draw base & bkg tiles
-    for(size_t j = 0; j != tm->height; ++j){
-        for(size_t i = 0; i != tm->width; ++i){
-            LinceQuadProps quad = {
-                .x = (float)i - tm->offset[0],
-                .y = (float)j - tm->offset[1],
-                .w = 1.001f, .h = 1.001f,
-                .color = {1,1,1,1},
-                .tile = &tm->tileset[tm->base_grid[j*tm->width + i]],
-                .zorder = LINCE_TILEMAP_Z
-            };
-            LinceDrawQuad(quad); // base tile
+/* Uploads the base and bkg tiles of a chunk to its quad mesh */
+static void LinceBuildTilemapChunk(LinceTilemap* tm, size_t cx, size_t cy){
+    size_t x0 = cx * LINCE_TILEMAP_CHUNK_SIZE;
+    size_t y0 = cy * LINCE_TILEMAP_CHUNK_SIZE;
+    size_t x1 = x0 + LINCE_TILEMAP_CHUNK_SIZE;
+    size_t y1 = y0 + LINCE_TILEMAP_CHUNK_SIZE;
+    if(x1 > tm->width)  x1 = tm->width;
+    if(y1 > tm->height) y1 = tm->height;
+
+    LinceQuadMesh* chunk = tm->chunks[cy * tm->chunks_x + cx];
+    float* xs = LinceMalloc(sizeof(float) * chunk->capacity);
+    float* ys = LinceMalloc(sizeof(float) * chunk->capacity);
+    float* zs = LinceMalloc(sizeof(float) * chunk->capacity);
+    LinceTile** tiles = LinceMalloc(sizeof(LinceTile*) * chunk->capacity);
+
+    // Positions are relative to the tilemap, which is moved by its offset when drawn
+    size_t n = 0;
+    for(size_t j = y0; j != y1; ++j){
+        for(size_t i = x0; i != x1; ++i){
+            size_t cell = j * tm->width + i;
+            xs[n] = (float)i;
+            ys[n] = (float)j;
+            zs[n] = LINCE_TILEMAP_Z;
+            tiles[n++] = &tm->tileset[tm->base_grid[cell]]; // base tile
 
             if(!tm->bkg_grid) continue;
-            quad.tile = &tm->tileset[tm->bkg_grid[j*tm->width + i]];
-            quad.zorder += 0.001f; // slightly above base grid
-            LinceDrawQuad(quad); // bkg tile
+            xs[n] = (float)i;
+            ys[n] = (float)j;
+            zs[n] = LINCE_TILEMAP_Z + 0.001f; // slightly above base grid
+            tiles[n++] = &tm->tileset[tm->bkg_grid[cell]]; // bkg tile
+        }
+    }
+
+    LinceSetQuadMeshData(chunk, &(LinceQuadArrays){
+        .count = n, .x = xs, .y = ys, .zorder = zs, .tiles = tiles,
+        .props = {.w = 1.001f, .h = 1.001f, .color = {1,1,1,1}}
+    });
+    tm->dirty_chunks[cy * tm->chunks_x + cx] = LinceFalse;
+
+    LinceFree(xs);
+    LinceFree(ys);
+    LinceFree(zs);
+    LinceFree(tiles);
+}
+
+
+static void LinceCreateTilemapChunks(LinceTilemap* tm){
+    const size_t size = LINCE_TILEMAP_CHUNK_SIZE;
+    tm->chunks_x = (tm->width  + size - 1) / size;
+    tm->chunks_y = (tm->height + size - 1) / size;
+    tm->chunks = LinceCalloc(sizeof(LinceQuadMesh*) * tm->chunks_x * tm->chunks_y);
+    tm->dirty_chunks = LinceCalloc(sizeof(LinceBool) * tm->chunks_x * tm->chunks_y);
+
+    size_t layers = tm->bkg_grid ? 2 : 1;
+    for(size_t cy = 0; cy != tm->chunks_y; ++cy){
+        for(size_t cx = 0; cx != tm->chunks_x; ++cx){
+            tm->chunks[cy * tm->chunks_x + cx] = LinceCreateQuadMesh(size * size * layers);
+            LinceBuildTilemapChunk(tm, cx, cy);
         }
     }
+}
+
+
+static void LinceDeleteTilemapChunks(LinceTilemap* tm){
+    if(!tm->chunks) return;
+    for(size_t i = 0; i != tm->chunks_x * tm->chunks_y; ++i){
+        LinceDeleteQuadMesh(tm->chunks[i]);
+    }
+    LinceFree(tm->chunks);
+    LinceFree(tm->dirty_chunks);
+}
 
+
+void LinceSetTilemapCell(
+    LinceTilemap* tm, LinceTilemapLayer layer,
+    size_t x, size_t y, uint32_t value
+){
+    LINCE_ASSERT(tm, "Tilemap missing");
+    LINCE_ASSERT(x < tm->width && y < tm->height,
+        "Cell (%d,%d) out of tilemap bounds (%d,%d)",
+        (int)x, (int)y, (int)tm->width, (int)tm->height);
+    
+    size_t cell = y * tm->width + x;
+    switch(layer){
+    case LinceTilemapLayer_Logic:
+        tm->logic_grid[cell] = (uint8_t)value;
+        return; // not drawn
+    case LinceTilemapLayer_Base:
+        LINCE_ASSERT(value < tm->tileset_size, "Invalid tile index %d", (int)value);
+        tm->base_grid[cell] = value;
+        break;
+    case LinceTilemapLayer_Bkg:
+        LINCE_ASSERT(tm->bkg_grid, "Tilemap has no bkg grid");
+        LINCE_ASSERT(value < tm->tileset_size, "Invalid tile index %d", (int)value);
+        tm->bkg_grid[cell] = value;
+        break;
+    }
+
+    size_t chunk = (y / LINCE_TILEMAP_CHUNK_SIZE) * tm->chunks_x
+                 + (x / LINCE_TILEMAP_CHUNK_SIZE);
+    tm->dirty_chunks[chunk] = LinceTrue;
+}
+
+
+/*
+Calculates the range of grid cells along one axis that overlap
+the view range [vmin, vmax], given the tilemap offset along that axis.
+Returns false if no cells are visible.
+*/
+static LinceBool LinceGetVisibleCells(
+    float vmin, float vmax, float offset, size_t cells, size_t range[2]
+){
+    // cell i is centered at i - offset and is one unit wide
+    float first = ceilf(vmin + offset - 0.5f);
+    float last = floorf(vmax + offset + 0.5f);
+    if(last < 0.0f || first >= (float)cells || first > last) return LinceFalse;
+    range[0] = first < 0.0f ? 0 : (size_t)first;
+    range[1] = last >= (float)cells ? cells - 1 : (size_t)last;
+    return LinceTrue;
+}
+
+
+static void LinceDrawTilemapGrids(LinceTilemap* tm){
+    size_t layers = tm->bkg_grid ? 2 : 1;
+    size_t total = tm->width * tm->height * layers;
+
+    // Draw only the chunks that overlap the view of the camera
+    vec4 view;
+    size_t xs[2], ys[2];
+    LinceGetSceneViewRect(view);
+    if(!LinceGetVisibleCells(view[0], view[2], tm->offset[0], tm->width, xs) ||
+       !LinceGetVisibleCells(view[1], view[3], tm->offset[1], tm->height, ys)){
+        LinceCountCulledQuads(total);
+        return;
+    }
+
+    mat4 transform;
+    glm_translate_make(transform, (vec3){-tm->offset[0], -tm->offset[1], 0.0f});
+
+    size_t drawn = 0;
+    for(size_t cy = ys[0] / LINCE_TILEMAP_CHUNK_SIZE; cy <= ys[1] / LINCE_TILEMAP_CHUNK_SIZE; ++cy){
+        for(size_t cx = xs[0] / LINCE_TILEMAP_CHUNK_SIZE; cx <= xs[1] / LINCE_TILEMAP_CHUNK_SIZE; ++cx){
+            size_t chunk = cy * tm->chunks_x + cx;
+            if(tm->dirty_chunks[chunk]) LinceBuildTilemapChunk(tm, cx, cy);
+            LinceDrawQuadMesh(tm->chunks[chunk], transform);
+            drawn += tm->chunks[chunk]->quad_count;
+        }
+    }
+    LinceCountCulledQuads(total - drawn);
 }
 
 
@@ -2,12 +2,25 @@
 #define LINCE_TILEMAP_H
 
 #include "lince/tiles/tileset.h"
+#include "lince/renderer/renderer.h"
 
 // Z value at which to draw the base grid of tilemaps
 #ifndef LINCE_TILEMAP_Z
 #define LINCE_TILEMAP_Z 0.0f
 #endif
 
+// Width and height in cells of the chunks in which tilemap grids are drawn
+#ifndef LINCE_TILEMAP_CHUNK_SIZE
+#define LINCE_TILEMAP_CHUNK_SIZE 32
+#endif
+
+/* Grids of a tilemap */
+typedef enum LinceTilemapLayer{
+    LinceTilemapLayer_Base,  // base_grid
+    LinceTilemapLayer_Bkg,   // bkg_grid
+    LinceTilemapLayer_Logic, // logic_grid
+} LinceTilemapLayer;
+
 /* Flags for Tilemap logic grid */
 typedef enum LinceTilemapBlockFlags{
     LinceTilemap_Empty   = 0x0,
@@ -42,6 +55,12 @@ typedef struct LinceTilemap{
     vec2* overlay_positions;
     size_t overlay_count;
 
+    // Geometry of base and bkg grids, kept on the GPU in square chunks.
+    // Set up by LinceCreateTilemap, chunks are rebuilt when their cells change.
+    LinceQuadMesh** chunks;
+    LinceBool* dirty_chunks; // chunks that must be rebuilt before drawing
+    size_t chunks_x, chunks_y; // number of chunks along each axis
+
     /*
     CallbackFn on_teleport(this, target-tilemap, trigger, ...)
     */
@@ -49,10 +68,28 @@ typedef struct LinceTilemap{
 } LinceTilemap;
 
 
+/*
+Creates a tilemap from the given settings, copying its grids,
+and builds the geometry of its grids. Requires an initialised renderer.
+*/
 LinceTilemap* LinceCreateTilemap(LinceTilemap* props);
 
 void LinceDeleteTilemap(LinceTilemap* tm);
 
+/*
+Changes the value of a cell at grid position (x,y) of one of the layers.
+Grids should be edited only through this function once the tilemap is created,
+as it marks the geometry of the cell's chunk for rebuilding.
+*/
+void LinceSetTilemapCell(
+    LinceTilemap* tm, LinceTilemapLayer layer,
+    size_t x, size_t y, uint32_t value
+);
+
+/*
+Draws the base and bkg grids with one draw call per chunk, and the overlay tiles.
+Only the chunks within the view of the scene camera are drawn.
+*/
 void LinceDrawTilemap(LinceTilemap* tm);
 
 #endif /* LINCE_TILEMAP_H */
\ No newline at end of file
@@ -1,17 +1,24 @@
-import pandas as pd
+import json
 import numpy as np
-from tqdm import tqdm
 
-data = pd.read_csv("profile.txt", delimiter=':', names=["Function","Runtime"])
-funcs = np.array(data['Function'].unique())
+# Chrome trace written by LinceStartProfiler, durations in microseconds
+with open("profile.json") as f:
+	events = json.load(f)["traceEvents"]
 
+runtimes = {}
+for e in events:
+	if e.get("ph") == "X":
+		runtimes.setdefault(e["name"], []).append(e["dur"] / 1000.0)
+
+funcs = np.array(list(runtimes.keys()))
 # Collect average runtime for each function
-means = np.array([data.loc[data['Function'] == f]['Runtime'].mean() for f in tqdm(funcs)])
-stds  = np.array([data.loc[data['Function'] == f]['Runtime'].std(ddof=0) for f in tqdm(funcs)])
+means = np.array([np.mean(runtimes[f]) for f in funcs])
+stds  = np.array([np.std(runtimes[f]) for f in funcs])
+calls = np.array([len(runtimes[f]) for f in funcs])
 # indices to sort runtimes from largest to shortest
 idx = np.argsort(means)[::-1]
 
 # Print out results
-print("Function".ljust(30) + "Mean execution time")
-for f,m,s in zip(funcs[idx], means[idx], stds[idx]):
-	print(f.ljust(30) + f"{float(m):.4f} +- {float(s):.4f} ms")
\ No newline at end of file
+print("Function".ljust(30) + "Calls".ljust(10) + "Mean execution time")
+for f,n,m,s in zip(funcs[idx], calls[idx], means[idx], stds[idx]):
+	print(f.ljust(30) + str(n).ljust(10) + f"{float(m):.4f} +- {float(s):.4f} ms")
@@ -0,0 +1,79 @@
+#include "tests.h"
+#include "test.h"
+#include "lince/tiles/atlas.h"
+
+#define PAGE_W 64
+#define PAGE_H 64
+
+typedef struct rect_t { uint32_t x, y, w, h; } rect_t;
+
+static int rects_overlap(rect_t a, rect_t b){
+	return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+int test_atlas_pack_shelves(){
+	array_t shelves = array_create(sizeof(LinceAtlasShelf));
+	rect_t rects[64];
+	uint32_t count = 0;
+
+	// images of mixed sizes until the page is full
+	srand(7);
+	for(int n = 0; n != 200; ++n){
+		rect_t r = {.w = 2 + rand() % 14, .h = 2 + rand() % 14};
+		if(!LincePackAtlasShelves(&shelves, PAGE_W, PAGE_H, r.w, r.h, &r.x, &r.y)){
+			continue;
+		}
+		TEST_ASSERT(count < 64, "Packed more images than can fit");
+		TEST_ASSERT(r.x >= LINCE_ATLAS_PADDING && r.y >= LINCE_ATLAS_PADDING &&
+			r.x + r.w + LINCE_ATLAS_PADDING <= PAGE_W &&
+			r.y + r.h + LINCE_ATLAS_PADDING <= PAGE_H,
+			"Image packed outside of page");
+		for(uint32_t i = 0; i != count; ++i){
+			TEST_ASSERT(!rects_overlap(r, rects[i]), "Packed images overlap");
+		}
+		rects[count++] = r;
+	}
+	TEST_ASSERT(count > 10, "Too few images packed");
+
+	// images larger than the page never fit
+	uint32_t x, y;
+	TEST_ASSERT(!LincePackAtlasShelves(&shelves, PAGE_W, PAGE_H, PAGE_W, 1, &x, &y),
+		"Image wider than page was packed");
+
+	array_destroy(&shelves);
+	return TEST_PASS;
+}
+
+int test_atlas_reuse_shelves(){
+	array_t shelves = array_create(sizeof(LinceAtlasShelf));
+	uint32_t x, y;
+
+	// images of the same height share a shelf
+	for(int n = 0; n != 4; ++n){
+		TEST_ASSERT(LincePackAtlasShelves(&shelves, PAGE_W, PAGE_H, 8, 8, &x, &y),
+			"Failed to pack image");
+	}
+	TEST_ASSERT(shelves.size == 1, "Images of same height placed on different shelves");
+	TEST_ASSERT(y == LINCE_ATLAS_PADDING, "Shelf not at the bottom of the page");
+
+	// shorter images go on the existing shelf, taller ones open a new one
+	LincePackAtlasShelves(&shelves, PAGE_W, PAGE_H, 4, 4, &x, &y);
+	TEST_ASSERT(shelves.size == 1, "Short image opened a new shelf");
+	LincePackAtlasShelves(&shelves, PAGE_W, PAGE_H, 4, 12, &x, &y);
+	TEST_ASSERT(shelves.size == 2, "Tall image did not open a new shelf");
+	TEST_ASSERT(y == 10 + LINCE_ATLAS_PADDING, "New shelf not above the first");
+
+	array_destroy(&shelves);
+	return TEST_PASS;
+}
+
+
+void atlas_test(){
+	struct test_t tests[] = {
+		{.fn = test_atlas_pack_shelves, .name = "test_atlas_pack_shelves"},
+		{.fn = test_atlas_reuse_shelves, .name = "test_atlas_reuse_shelves"},
+	};
+	uint32_t count = sizeof(tests) / sizeof(struct test_t);
+
+	run_tests(tests, count, "atlas");
+}
@@ -0,0 +1,295 @@
+#include "tests.h"
+#include "test.h"
+#include "lince/renderer/block_compression.h"
+#include <math.h>
+
+#define IMAGE_SIZE 64
+#define N_BENCH_IMAGES 20
+
+/* Reference decoders, following the format specifications */
+
+static void decode_565(uint16_t c, int rgb[3]){
+	int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+static void decode_color_block(const unsigned char* block, int four_colors, unsigned char out[64]){
+	uint16_t c0 = (uint16_t)(block[0] | block[1] << 8), c1 = (uint16_t)(block[2] | block[3] << 8);
+	uint32_t indices = block[4] | block[5] << 8 | block[6] << 16 | (uint32_t)block[7] << 24;
+	int p[4][4] = {{0}};
+	decode_565(c0, p[0]);
+	decode_565(c1, p[1]);
+	p[0][3] = p[1][3] = p[2][3] = p[3][3] = 255;
+	if(four_colors || c0 > c1){
+		for(int c = 0; c != 3; ++c){
+			p[2][c] = (2*p[0][c] + p[1][c]) / 3;
+			p[3][c] = (p[0][c] + 2*p[1][c]) / 3;
+		}
+	} else {
+		for(int c = 0; c != 3; ++c) p[2][c] = (p[0][c] + p[1][c]) / 2;
+		p[3][3] = 0;
+	}
+	for(int i = 0; i != 16; ++i){
+		int k = (indices >> (2*i)) & 3;
+		for(int c = 0; c != 4; ++c) out[i*4 + c] = (unsigned char)p[k][c];
+	}
+}
+
+static void decode_bc3_block(const unsigned char* block, unsigned char out[64]){
+	decode_color_block(block + 8, 1, out);
+	int a[8] = {block[0], block[1]};
+	if(a[0] > a[1]){
+		for(int i = 1; i != 7; ++i) a[i+1] = ((7-i)*a[0] + i*a[1]) / 7;
+	} else {
+		for(int i = 1; i != 5; ++i) a[i+1] = ((5-i)*a[0] + i*a[1]) / 5;
+		a[6] = 0;
+		a[7] = 255;
+	}
+	uint64_t indices = 0;
+	for(int i = 0; i != 6; ++i) indices |= (uint64_t)block[2+i] << (8*i);
+	for(int i = 0; i != 16; ++i) out[i*4 + 3] = (unsigned char)a[(indices >> (3*i)) & 7];
+}
+
+static uint32_t read_bits(const unsigned char* block, int* pos, int bits){
+	uint32_t v = 0;
+	for(int i = 0; i != bits; ++i, ++(*pos)){
+		v |= (uint32_t)((block[*pos / 8] >> (*pos % 8)) & 1) << i;
+	}
+	return v;
+}
+
+/* Decodes BC7 mode 6 only, returning false for other modes */
+static int decode_bc7_block(const unsigned char* block, unsigned char out[64]){
+	static const int weights[16] = {0,4,9,13,17,21,26,30,34,38,43,47,51,55,60,64};
+	int pos = 0;
+	if(read_bits(block, &pos, 7) != (1u << 6)) return 0;
+	int e[2][4];
+	for(int c = 0; c != 4; ++c){
+		e[0][c] = (int)read_bits(block, &pos, 7);
+		e[1][c] = (int)read_bits(block, &pos, 7);
+	}
+	int p0 = (int)read_bits(block, &pos, 1), p1 = (int)read_bits(block, &pos, 1);
+	for(int c = 0; c != 4; ++c){
+		e[0][c] = e[0][c] << 1 | p0;
+		e[1][c] = e[1][c] << 1 | p1;
+	}
+	for(int i = 0; i != 16; ++i){
+		int w = weights[read_bits(block, &pos, i == 0 ? 3 : 4)];
+		for(int c = 0; c != 4; ++c){
+			out[i*4 + c] = (unsigned char)(((64 - w) * e[0][c] + w * e[1][c] + 32) >> 6);
+		}
+	}
+	return 1;
+}
+
+/* Root mean square error over all channels of two blocks */
+static float block_error(const unsigned char* a, const unsigned char* b, int channels){
+	float err = 0.0f;
+	for(int i = 0; i != 16; ++i){
+		for(int c = 0; c != channels; ++c){
+			float d = (float)a[i*4 + c] - (float)b[i*4 + c];
+			err += d * d;
+		}
+	}
+	return sqrtf(err / (16.0f * channels));
+}
+
+/* Smooth diagonal gradient block, with varying alpha */
+static void gradient_block(unsigned char pixels[64], int seed){
+	for(int i = 0; i != 16; ++i){
+		int t = i % 4 + i / 4;
+		pixels[i*4 + 0] = (unsigned char)(seed * 13 + t * 12);
+		pixels[i*4 + 1] = (unsigned char)(seed * 7 + t * 9);
+		pixels[i*4 + 2] = (unsigned char)(200 - t * 10);
+		pixels[i*4 + 3] = (unsigned char)(255 - t * 15);
+	}
+}
+
+int test_bc1_block(){
+	unsigned char pixels[64], block[8], out[64];
+
+	// colors exactly representable in 5:6:5 bits are kept
+	for(int i = 0; i != 16; ++i){
+		int k = i % 2;
+		pixels[i*4 + 0] = k ? 255 : 0;
+		pixels[i*4 + 1] = k ? 0 : 255;
+		pixels[i*4 + 2] = 0;
+		pixels[i*4 + 3] = 255;
+	}
+	LinceEncodeBC1Block(pixels, block);
+	decode_color_block(block, 0, out);
+	TEST_ASSERT(memcmp(pixels, out, 64) == 0, "Two-color BC1 block not exact");
+
+	// transparent pixels stay transparent
+	pixels[3] = 0;
+	pixels[7] = 0;
+	LinceEncodeBC1Block(pixels, block);
+	decode_color_block(block, 0, out);
+	TEST_ASSERT(out[3] == 0 && out[7] == 0 && out[11] == 255, "Wrong BC1 transparency");
+
+	for(int s = 0; s != 10; ++s){
+		gradient_block(pixels, s);
+		for(int i = 0; i != 16; ++i) pixels[i*4 + 3] = 255;
+		LinceEncodeBC1Block(pixels, block);
+		decode_color_block(block, 0, out);
+		TEST_ASSERT(block_error(pixels, out, 3) < 8.0f, "BC1 gradient error too large");
+	}
+	return TEST_PASS;
+}
+
+int test_bc3_block(){
+	unsigned char pixels[64], block[16], out[64];
+	for(int s = 0; s != 10; ++s){
+		gradient_block(pixels, s);
+		LinceEncodeBC3Block(pixels, block);
+		decode_bc3_block(block, out);
+		TEST_ASSERT(block_error(pixels, out, 3) < 8.0f, "BC3 color error too large");
+		for(int i = 0; i != 16; ++i){
+			TEST_ASSERT(abs(pixels[i*4 + 3] - out[i*4 + 3]) <= 18, "BC3 alpha error too large");
+		}
+	}
+	return TEST_PASS;
+}
+
+int test_bc7_block(){
+	unsigned char pixels[64], block[16], out[64];
+
+	// solid colors are kept to within one step
+	for(int i = 0; i != 16; ++i){
+		pixels[i*4 + 0] = 31;
+		pixels[i*4 + 1] = 200;
+		pixels[i*4 + 2] = 77;
+		pixels[i*4 + 3] = 128;
+	}
+	LinceEncodeBC7Block(pixels, block);
+	TEST_ASSERT(decode_bc7_block(block, out), "BC7 block not in mode 6");
+	for(int i = 0; i != 64; ++i){
+		TEST_ASSERT(abs(pixels[i] - out[i]) <= 1, "Solid BC7 block not kept");
+	}
+
+	for(int s = 0; s != 10; ++s){
+		gradient_block(pixels, s);
+		LinceEncodeBC7Block(pixels, block);
+		TEST_ASSERT(decode_bc7_block(block, out), "BC7 block not in mode 6");
+		TEST_ASSERT(block_error(pixels, out, 4) < 4.0f, "BC7 gradient error too large");
+	}
+	return TEST_PASS;
+}
+
+int test_decompress_image(){
+	// diagonal gradient over 6x5 pixels, so that the right and top blocks are cut off
+	enum { W = 6, H = 5 };
+	unsigned char image[W * H * 4], out[W * H * 4], blocks[4 * 16];
+	for(int i = 0; i != W * H; ++i){
+		int t = i % W + i / W;
+		image[i*4 + 0] = (unsigned char)(t * 8);
+		image[i*4 + 1] = (unsigned char)(t * 6);
+		image[i*4 + 2] = 90;
+		image[i*4 + 3] = (unsigned char)(255 - t * 6);
+	}
+
+	// matches the reference decoders block by block
+	unsigned char pixels[64], expected[64];
+	LinceCompressImage(LinceTextureFormat_BC1, image, W, H, blocks);
+	LinceDecodeBC1Block(blocks, pixels);
+	decode_color_block(blocks, 0, expected);
+	TEST_ASSERT(memcmp(pixels, expected, 64) == 0, "BC1 block differs from reference");
+	LinceCompressImage(LinceTextureFormat_BC3, image, W, H, blocks);
+	LinceDecodeBC3Block(blocks + 16, pixels);
+	decode_bc3_block(blocks + 16, expected);
+	TEST_ASSERT(memcmp(pixels, expected, 64) == 0, "BC3 block differs from reference");
+
+	LinceDecompressImage(LinceTextureFormat_BC3, blocks, W, H, out);
+	for(int i = 0; i != W * H * 4; ++i){
+		TEST_ASSERT(abs(image[i] - out[i]) <= 8, "Decompressed BC3 image differs");
+	}
+	return TEST_PASS;
+}
+
+/* Receives levels built by LinceBuildTextureLevels */
+typedef struct levels_t {
+	uint32_t count;
+	size_t sizes[16];
+	unsigned char last[16];
+} levels_t;
+
+static LinceBool count_level(void* user_data, uint32_t level, const unsigned char* data, size_t size){
+	levels_t* levels = user_data;
+	if(level != levels->count) return LinceFalse;
+	levels->sizes[levels->count++] = size;
+	memcpy(levels->last, data, size < 16 ? size : 16);
+	return LinceTrue;
+}
+
+int test_build_texture_levels(){
+	// uniform image keeps its color on every level
+	enum { W = 10, H = 6 };
+	unsigned char image[W * H * 4];
+	for(int i = 0; i != W * H; ++i){
+		image[i*4 + 0] = 10;
+		image[i*4 + 1] = 20;
+		image[i*4 + 2] = 30;
+		image[i*4 + 3] = 255;
+	}
+	uint32_t n = LinceGetMipLevelCount(W, H);
+	TEST_ASSERT(n == 4, "Wrong number of mip levels");
+
+	levels_t levels = {0};
+	TEST_ASSERT(LinceBuildTextureLevels(image, W, H, LinceTextureFormat_RGBA8, n, count_level, &levels),
+		"Failed to build RGBA levels");
+	TEST_ASSERT(levels.count == 4, "Wrong number of RGBA levels");
+	TEST_ASSERT(levels.sizes[1] == 5*3*4 && levels.sizes[3] == 1*1*4, "Wrong RGBA level size");
+	TEST_ASSERT(levels.last[0] == 10 && levels.last[2] == 30, "Wrong downsampled color");
+
+	// 10x6, 5x3, 2x1, 1x1 are 3x2, 2x1, 1 and 1 blocks
+	levels = (levels_t){0};
+	TEST_ASSERT(LinceBuildTextureLevels(image, W, H, LinceTextureFormat_BC7, n, count_level, &levels),
+		"Failed to build BC7 levels");
+	TEST_ASSERT(levels.sizes[0] == 6*16 && levels.sizes[1] == 2*16 && levels.sizes[3] == 16,
+		"Wrong BC7 level size");
+	unsigned char out[64];
+	TEST_ASSERT(decode_bc7_block(levels.last, out) && out[0] == 10 && out[1] == 20,
+		"Wrong compressed mip level");
+	return TEST_PASS;
+}
+
+/* Measures pixels compressed per millisecond */
+int bench_compress_image(){
+	unsigned char* image = malloc(IMAGE_SIZE * IMAGE_SIZE * 4);
+	unsigned char* blocks = malloc(IMAGE_SIZE * IMAGE_SIZE);
+	TEST_ASSERT(image && blocks, "Failed to allocate image");
+	srand(11);
+	for(int i = 0; i != IMAGE_SIZE * IMAGE_SIZE * 4; ++i) image[i] = (unsigned char)(rand() % 256);
+	long int n_op = (long)IMAGE_SIZE * IMAGE_SIZE * N_BENCH_IMAGES;
+
+	const char* names[] = {"BC1", "BC3", "BC7"};
+	LinceTextureFormat formats[] = {LinceTextureFormat_BC1, LinceTextureFormat_BC3, LinceTextureFormat_BC7};
+	for(int f = 0; f != 3; ++f){
+		printf("[%s] ", names[f]);
+		TEST_CLOCK_START(time_compress);
+		for(int n = 0; n != N_BENCH_IMAGES; ++n){
+			LinceCompressImage(formats[f], image, IMAGE_SIZE, IMAGE_SIZE, blocks);
+		}
+		TEST_CLOCK_END(time_compress, n_op);
+	}
+	free(image);
+	free(blocks);
+	return TEST_PASS;
+}
+
+
+void block_compression_test(){
+	struct test_t tests[] = {
+		{.fn = test_bc1_block,            .name = "test_bc1_block"},
+		{.fn = test_bc3_block,            .name = "test_bc3_block"},
+		{.fn = test_bc7_block,            .name = "test_bc7_block"},
+		{.fn = test_decompress_image,     .name = "test_decompress_image"},
+		{.fn = test_build_texture_levels, .name = "test_build_texture_levels"},
+		{.fn = bench_compress_image,      .name = "bench_compress_image"},
+	};
+	uint32_t count = sizeof(tests) / sizeof(struct test_t);
+
+	run_tests(tests, count, "block_compression");
+}
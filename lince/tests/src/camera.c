@@ -0,0 +1,53 @@
+#include "tests.h"
+#include "test.h"
+#include "lince/renderer/camera.h"
+#include <math.h>
+
+#define EPS 1e-4f
+
+static int rect_equals(vec4 rect, float xmin, float ymin, float xmax, float ymax){
+	return fabsf(rect[0] - xmin) < EPS && fabsf(rect[1] - ymin) < EPS &&
+	       fabsf(rect[2] - xmax) < EPS && fabsf(rect[3] - ymax) < EPS;
+}
+
+int test_camera_view_rect(){
+	vec4 rect;
+	LinceCamera* cam = LinceCreateCamera(2.0f);
+	TEST_ASSERT(cam, "Failed to create camera");
+
+	// new camera sees its projection bounds
+	LinceGetCameraViewRect(cam, rect);
+	TEST_ASSERT(rect_equals(rect, -2.0f, -1.0f, 2.0f, 1.0f),
+		"View of new camera differs from its projection");
+
+	// moved and zoomed out
+	cam->pos[0] = 10.0f;
+	cam->pos[1] = -5.0f;
+	cam->scale = 3.0f;
+	LinceUpdateCamera(cam);
+	LinceGetCameraViewRect(cam, rect);
+	TEST_ASSERT(rect_equals(rect, 24.0f, -18.0f, 36.0f, -12.0f),
+		"View of moved and scaled camera is wrong");
+
+	// rotated by 90 degrees, width and height swap
+	cam->pos[0] = cam->pos[1] = 0.0f;
+	cam->scale = 1.0f;
+	cam->rotation = 90.0f;
+	LinceUpdateCamera(cam);
+	LinceGetCameraViewRect(cam, rect);
+	TEST_ASSERT(rect_equals(rect, -1.0f, -2.0f, 1.0f, 2.0f),
+		"View of rotated camera is wrong");
+
+	LinceDeleteCamera(cam);
+	return TEST_PASS;
+}
+
+
+void camera_test(){
+	struct test_t tests[] = {
+		{.fn = test_camera_view_rect, .name = "test_camera_view_rect"},
+	};
+	uint32_t count = sizeof(tests) / sizeof(struct test_t);
+
+	run_tests(tests, count, "camera");
+}
@@ -0,0 +1,167 @@
+#include "tests.h"
+#include "test.h"
+#include "lince/renderer/cooked_texture.h"
+#include "lince/core/profiler.h"
+#include "lince/core/window.h"
+#include <glad/glad.h>
+#include <stb_image.h>
+
+#ifdef LINCE_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define COOKED_TEST_FILE "test_cooked_texture.ltex"
+#define COOKED_BENCH_PATH LINCE_DIR"deps/cglm/cglm.png"
+#define N_WARM_LOADS 10
+
+int test_cook_texture(){
+	// 5x3 image whose pixels hold their own coordinates
+	enum { W = 5, H = 3 };
+	unsigned char image[W * H * 4];
+	for(int i = 0; i != W * H; ++i){
+		image[i*4 + 0] = (unsigned char)(i % W * 40);
+		image[i*4 + 1] = (unsigned char)(i / W * 40);
+		image[i*4 + 2] = 7;
+		image[i*4 + 3] = 0xFF;
+	}
+	TEST_ASSERT(LinceCookTextureData(COOKED_TEST_FILE, image, W, H, LinceTexture_Mipmaps),
+		"Failed to cook texture");
+
+	LinceCookedTexture cooked;
+	TEST_ASSERT(LinceMapCookedTexture(COOKED_TEST_FILE, &cooked), "Failed to map cooked texture");
+	LinceCookedTextureHeader h = cooked.header;
+	TEST_ASSERT(h.width == W && h.height == H, "Wrong cooked texture size");
+	TEST_ASSERT(h.format == LinceTextureFormat_RGBA8, "Wrong cooked texture format");
+	TEST_ASSERT(h.opaque, "Opaque image not marked opaque");
+
+	// 5x3, 2x1, 1x1
+	TEST_ASSERT(h.levels == 3, "Wrong number of mip levels");
+	TEST_ASSERT(cooked.size == (W*H + 2 + 1) * 4, "Wrong size of mip chain");
+	TEST_ASSERT(memcmp(cooked.data, image, sizeof(image)) == 0, "First level differs from image");
+
+	// second level pixel (1,0) averages pixels (2,0), (3,0), (2,1) and (3,1)
+	const unsigned char* level1 = cooked.data + sizeof(image);
+	TEST_ASSERT(level1[4] == 100 && level1[5] == 20 && level1[6] == 7,
+		"Wrong averaged mip level");
+
+	LinceUnmapCookedTexture(&cooked);
+	TEST_ASSERT(cooked.mapping == NULL, "Cooked texture still mapped");
+	remove(COOKED_TEST_FILE);
+	return TEST_PASS;
+}
+
+int test_invalid_cooked_texture(){
+	LinceCookedTexture cooked;
+	TEST_ASSERT(!LinceMapCookedTexture("missing.ltex", &cooked), "Mapped missing file");
+
+	// valid header with missing data
+	unsigned char image[16 * 16 * 4] = {0};
+	TEST_ASSERT(LinceCookTextureData(COOKED_TEST_FILE, image, 16, 16, 0), "Failed to cook texture");
+	FILE* file = fopen(COOKED_TEST_FILE, "r+b");
+	TEST_ASSERT(file, "Failed to open cooked texture");
+	LinceCookedTextureHeader header;
+	TEST_ASSERT(fread(&header, sizeof(header), 1, file) == 1, "Failed to read header");
+	fclose(file);
+
+	file = fopen(COOKED_TEST_FILE, "wb");
+	fwrite(&header, sizeof(header), 1, file);
+	fwrite(image, 100, 1, file);
+	fclose(file);
+	TEST_ASSERT(!LinceMapCookedTexture(COOKED_TEST_FILE, &cooked), "Mapped truncated file");
+
+	// wrong magic
+	file = fopen(COOKED_TEST_FILE, "wb");
+	fwrite("PNG!", 4, 1, file);
+	fwrite(image, sizeof(image), 1, file);
+	fclose(file);
+	TEST_ASSERT(!LinceMapCookedTexture(COOKED_TEST_FILE, &cooked), "Mapped file of another format");
+
+	remove(COOKED_TEST_FILE);
+	return TEST_PASS;
+}
+
+/* Evicts a file from the OS page cache, so that the next read comes from disk */
+static void drop_file_cache(const char* path){
+#ifdef LINCE_LINUX
+	int fd = open(path, O_RDONLY);
+	if(fd < 0) return;
+	fdatasync(fd);
+	posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+	close(fd);
+#else
+	LINCE_UNUSED(path); // first loads may be served from the cache
+#endif
+}
+
+/*
+Loads a texture from a PNG or cooked file once after evicting it from the page cache (cold),
+and then N_WARM_LOADS times (warm), including the upload. Returns the texture of the last load.
+*/
+static LinceTexture* time_texture_loads(const char* path, LinceBool cooked,
+	double* cold_ms, double* warm_ms){
+	LinceTexture* texture = NULL;
+	drop_file_cache(path);
+	for(int n = 0; n != N_WARM_LOADS + 1; ++n){
+		if(texture) LinceDeleteTexture(texture);
+		double start = LinceGetTimeMillisec();
+		if(cooked) texture = LinceLoadCookedTexture("cooked", path);
+		else texture = LinceLoadTexture("png", path, LinceTexture_FlipY);
+		glFinish();
+		double ms = LinceGetTimeMillisec() - start;
+		if(n == 0) *cold_ms = ms;
+		else *warm_ms += ms / N_WARM_LOADS;
+	}
+	return texture;
+}
+
+/*
+Compares the first (cold) and repeated (warm) loads of the same image
+from a PNG file and from a cooked file, with the upload, on a headless context.
+*/
+int bench_cooked_texture_load(){
+	LinceWindow* window = LinceCreateWindow(64, 64, "cooked_texture", LinceWindow_Headless);
+	TEST_ASSERT(window, "Failed to create headless window");
+	TEST_ASSERT(LinceCookTexture(COOKED_BENCH_PATH, COOKED_TEST_FILE, LinceTexture_FlipY),
+		"Failed to cook texture");
+
+	double png_cold = 0.0, png_warm = 0.0, cooked_cold = 0.0, cooked_warm = 0.0;
+	LinceTexture* png = time_texture_loads(COOKED_BENCH_PATH, LinceFalse, &png_cold, &png_warm);
+	LinceTexture* cooked = time_texture_loads(COOKED_TEST_FILE, LinceTrue, &cooked_cold, &cooked_warm);
+	TEST_ASSERT(png && cooked, "Failed to load texture");
+	TEST_ASSERT(png->width == cooked->width && png->height == cooked->height,
+		"Cooked texture size differs from image");
+
+	size_t size = (size_t)png->width * png->height * 4;
+	unsigned char* png_pixels = malloc(size);
+	unsigned char* cooked_pixels = malloc(size);
+	glGetTextureImage(png->id, 0, GL_RGBA, GL_UNSIGNED_BYTE, (GLsizei)size, png_pixels);
+	glGetTextureImage(cooked->id, 0, GL_RGBA, GL_UNSIGNED_BYTE, (GLsizei)size, cooked_pixels);
+	TEST_ASSERT(glGetError() == GL_NO_ERROR, "OpenGL error");
+	int same = memcmp(png_pixels, cooked_pixels, size) == 0;
+	uint32_t width = png->width, height = png->height;
+	free(png_pixels);
+	free(cooked_pixels);
+
+	LinceDeleteTexture(png);
+	LinceDeleteTexture(cooked);
+	LinceDestroyWindow(window);
+	remove(COOKED_TEST_FILE);
+
+	printf("%s: %ux%u image, cold/warm load: png %.2f/%.2f ms, cooked %.2f/%.2f ms\n",
+		__FUNCTION__, width, height, png_cold, png_warm, cooked_cold, cooked_warm);
+	TEST_ASSERT(same, "Cooked texture differs from image");
+	return TEST_PASS;
+}
+
+
+void cooked_texture_test(){
+	struct test_t tests[] = {
+		{.fn = test_cook_texture,           .name = "test_cook_texture"},
+		{.fn = test_invalid_cooked_texture, .name = "test_invalid_cooked_texture"},
+		{.fn = bench_cooked_texture_load,   .name = "bench_cooked_texture_load"},
+	};
+	uint32_t count = sizeof(tests) / sizeof(struct test_t);
+
+	run_tests(tests, count, "cooked_texture");
+}
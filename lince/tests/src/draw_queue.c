@@ -0,0 +1,92 @@
+#include "tests.h"
+#include "test.h"
+#include "lince/renderer/draw_queue.h"
+
+#define N_KEYS 1000000
+
+static float randf(float min, float max){
+	return min + (max - min) * (float)rand() / (float)RAND_MAX;
+}
+
+int test_draw_key_order(){
+	// opaque before translucent
+	TEST_ASSERT(LinceMakeDrawKey(LinceFalse, -5.0f, 0xFFFF) < LinceMakeDrawKey(LinceTrue, 5.0f, 0),
+		"Opaque quad sorted after translucent quad");
+	// opaque grouped by texture, then front to back
+	TEST_ASSERT(LinceMakeDrawKey(LinceFalse, 0.0f, 1) < LinceMakeDrawKey(LinceFalse, 1.0f, 2),
+		"Opaque quads not grouped by texture");
+	TEST_ASSERT(LinceMakeDrawKey(LinceFalse, 0.5f, 1) < LinceMakeDrawKey(LinceFalse, -0.5f, 1),
+		"Opaque quads not sorted front to back");
+	// translucent back to front regardless of texture
+	TEST_ASSERT(LinceMakeDrawKey(LinceTrue, -0.5f, 9) < LinceMakeDrawKey(LinceTrue, 0.5f, 1),
+		"Translucent quads not sorted back to front");
+	TEST_ASSERT(LinceMakeDrawKey(LinceTrue, 0.5f, 9) == LinceMakeDrawKey(LinceTrue, 0.5f, 1),
+		"Translucent quads sorted by texture");
+	return TEST_PASS;
+}
+
+int test_sort_draw_keys(){
+	const size_t n = 10000;
+	LinceDrawKey* keys = malloc(sizeof(LinceDrawKey) * n);
+	LinceDrawKey* scratch = malloc(sizeof(LinceDrawKey) * n);
+	TEST_ASSERT(keys && scratch, "Failed to allocate keys");
+
+	// few distinct values so that many keys are equal
+	srand(3);
+	for(size_t i = 0; i != n; ++i){
+		LinceBool translucent = rand() % 2;
+		float z = (float)(rand() % 5) - 2.0f;
+		keys[i] = (LinceDrawKey){
+			.key = LinceMakeDrawKey(translucent, z, rand() % 4),
+			.index = (uint32_t)i
+		};
+	}
+	LinceSortDrawKeys(keys, scratch, n);
+
+	for(size_t i = 1; i != n; ++i){
+		TEST_ASSERT(keys[i-1].key <= keys[i].key, "Keys not sorted");
+		if(keys[i-1].key == keys[i].key){
+			TEST_ASSERT(keys[i-1].index < keys[i].index, "Equal keys changed order");
+		}
+	}
+
+	free(keys);
+	free(scratch);
+	return TEST_PASS;
+}
+
+/* Measures keys sorted per millisecond */
+int bench_sort_draw_keys(){
+	LinceDrawKey* keys = malloc(sizeof(LinceDrawKey) * N_KEYS);
+	LinceDrawKey* scratch = malloc(sizeof(LinceDrawKey) * N_KEYS);
+	TEST_ASSERT(keys && scratch, "Failed to allocate keys");
+	long int n_op = N_KEYS;
+
+	srand(5);
+	for(uint32_t i = 0; i != N_KEYS; ++i){
+		keys[i] = (LinceDrawKey){
+			.key = LinceMakeDrawKey(rand() % 2, randf(-1, 1), rand() % 32),
+			.index = i
+		};
+	}
+	TEST_CLOCK_START(time_sort);
+	LinceSortDrawKeys(keys, scratch, N_KEYS);
+	TEST_CLOCK_END(time_sort, n_op);
+
+	int sorted = keys[0].key <= keys[N_KEYS-1].key;
+	free(keys);
+	free(scratch);
+	return sorted ? TEST_PASS : TEST_FAIL;
+}
+
+
+void draw_queue_test(){
+	struct test_t tests[] = {
+		{.fn = test_draw_key_order,  .name = "test_draw_key_order"},
+		{.fn = test_sort_draw_keys,  .name = "test_sort_draw_keys"},
+		{.fn = bench_sort_draw_keys, .name = "bench_sort_draw_keys"},
+	};
+	uint32_t count = sizeof(tests) / sizeof(struct test_t);
+
+	run_tests(tests, count, "draw_queue");
+}
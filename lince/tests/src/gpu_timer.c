@@ -0,0 +1,62 @@
+#include "tests.h"
+#include "test.h"
+#include "lince/core/window.h"
+#include "lince/core/profiler.h"
+#include "lince/renderer/gpu_timer.h"
+
+#include <glad/glad.h>
+
+#define GPU_TIMER_TEST_FILE "test_gpu_profile.json"
+#define N_FRAMES 4
+
+/* Times nested scopes around clears on a headless context, e.g. Mesa's llvmpipe */
+int test_gpu_timer_frames(){
+	LinceWindow* window = LinceCreateWindow(64, 64, "gpu_timer", LinceWindow_Headless);
+	TEST_ASSERT(window, "Failed to create headless window");
+	if(!LinceIsGPUTimerSupported()){
+		printf("%s: timestamp queries not supported, skipped\n", __FUNCTION__);
+		LinceDestroyWindow(window);
+		return TEST_PASS;
+	}
+
+	LinceInitGPUTimer();
+	TEST_ASSERT(LinceStartProfiler(GPU_TIMER_TEST_FILE), "Failed to start profiler");
+	for(int i = 0; i != N_FRAMES; ++i){
+		LinceGPUScope frame = LinceBeginGPUScope("frame");
+		LinceGPUScope pass = LinceBeginGPUScope("pass");
+		glClearColor(0.1f * (float)i, 0.2f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		LinceEndGPUScope(pass);
+		LinceEndGPUScope(frame);
+		glFinish(); // so that no frame is dropped
+		LinceEndGPUTimerFrame();
+	}
+	LinceStopProfiler();
+	LinceTerminateGPUTimer();
+
+	// errors can only be read while the context is alive
+	TEST_ASSERT(glGetError() == GL_NO_ERROR, "OpenGL error");
+	LinceDestroyWindow(window);
+	TEST_ASSERT(LinceGetGPUTimerDroppedFrames() == 0, "GPU timer dropped frames");
+	TEST_ASSERT(LinceGetGPUFrameTime() >= 0.0f, "Negative GPU frame time");
+
+	// results of the last frame are still in flight
+	TEST_ASSERT(count_in_file(GPU_TIMER_TEST_FILE, "\"name\":\"frame\"") == N_FRAMES - 1,
+		"Wrong number of GPU frames");
+	TEST_ASSERT(count_in_file(GPU_TIMER_TEST_FILE, "\"tid\":1000,\"args\":{\"depth\":1}") == N_FRAMES - 1,
+		"Wrong depth of nested GPU scopes");
+	TEST_ASSERT(count_in_file(GPU_TIMER_TEST_FILE, "\"args\":{\"name\":\"GPU\"}") == 1,
+		"GPU thread not named");
+	remove(GPU_TIMER_TEST_FILE);
+	return TEST_PASS;
+}
+
+
+void gpu_timer_test(){
+	struct test_t tests[] = {
+		{.fn = test_gpu_timer_frames, .name = "test_gpu_timer_frames"},
+	};
+	uint32_t count = sizeof(tests) / sizeof(struct test_t);
+
+	run_tests(tests, count, "gpu_timer");
+}
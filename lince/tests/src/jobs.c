@@ -0,0 +1,241 @@
+#include "tests.h"
+#include "test.h"
+#include "lince/core/jobs.h"
+#include "lince/core/profiler.h"
+#include <math.h>
+
+#define N_JOBS 1000
+#define N_ITEMS 200000
+#define N_WORK 200
+#define N_BENCH_RUNS 5
+
+/* Writes twice the index of each slot */
+static void double_slot(void* data){
+	long* slot = data;
+	*slot = *slot * 2;
+}
+
+int test_run_jobs(){
+	LinceJobSystem* sys = LinceCreateJobSystem(4);
+	TEST_ASSERT(LinceGetJobThreadCount(sys) == 4, "Wrong number of threads");
+
+	long slots[N_JOBS];
+	LinceJobCounter counter = {0};
+	for(long i = 0; i != N_JOBS; ++i){
+		slots[i] = i;
+		LinceRunJob(sys, double_slot, slots + i, &counter);
+	}
+	LinceWaitForCounter(sys, &counter);
+
+	TEST_ASSERT(counter.value == 0, "Counter not zero after waiting");
+	for(long i = 0; i != N_JOBS; ++i){
+		TEST_ASSERT(slots[i] == i * 2, "Job did not run exactly once");
+	}
+	LinceDeleteJobSystem(sys);
+	return TEST_PASS;
+}
+
+/* Stages of a chain of jobs, each one checking that the previous one finished */
+typedef struct stage_t {
+	volatile long* done;
+	long index;
+	int in_order;
+} stage_t;
+
+static void run_stage(void* data){
+	stage_t* stage = data;
+	stage->in_order = (stage->index == 0) || stage->done[stage->index - 1];
+	stage->done[stage->index] = 1;
+}
+
+int test_job_dependencies(){
+	LinceJobSystem* sys = LinceCreateJobSystem(4);
+
+	// queued together, so that counters are held before any stage runs,
+	// and taken newest first, before their dependencies
+	enum { N_STAGES = 16 };
+	volatile long done[N_STAGES] = {0};
+	stage_t stages[N_STAGES];
+	LinceJob jobs[N_STAGES];
+	LinceJobCounter counters[N_STAGES] = {0};
+	for(long i = 0; i != N_STAGES; ++i){
+		stages[i] = (stage_t){.done = done, .index = i};
+		jobs[i] = (LinceJob){
+			.fn = run_stage, .data = stages + i,
+			.counter = counters + i,
+			.dependency = i > 0 ? counters + i - 1 : NULL
+		};
+	}
+	LinceRunJobs(sys, jobs, N_STAGES);
+	LinceWaitForCounter(sys, counters + N_STAGES - 1);
+
+	for(int i = 0; i != N_STAGES; ++i){
+		TEST_ASSERT(done[i], "Stage did not run");
+		TEST_ASSERT(stages[i].in_order, "Stage ran before its dependency");
+	}
+	LinceDeleteJobSystem(sys);
+	return TEST_PASS;
+}
+
+/* Recursive sum that forks into two jobs and joins them */
+typedef struct sum_t {
+	LinceJobSystem* sys;
+	const long* values;
+	size_t count;
+	long result;
+} sum_t;
+
+static void sum_values(void* data){
+	sum_t* sum = data;
+	if(sum->count <= 64){
+		sum->result = 0;
+		for(size_t i = 0; i != sum->count; ++i) sum->result += sum->values[i];
+		return;
+	}
+	size_t half = sum->count / 2;
+	sum_t left  = {.sys = sum->sys, .values = sum->values, .count = half};
+	sum_t right = {.sys = sum->sys, .values = sum->values + half, .count = sum->count - half};
+	LinceJobCounter counter = {0};
+	LinceRunJob(sum->sys, sum_values, &left, &counter);
+	LinceRunJob(sum->sys, sum_values, &right, &counter);
+	LinceWaitForCounter(sum->sys, &counter);
+	sum->result = left.result + right.result;
+}
+
+int test_nested_jobs(){
+	LinceJobSystem* sys = LinceCreateJobSystem(4);
+	long* values = malloc(sizeof(long) * N_ITEMS);
+	TEST_ASSERT(values, "Failed to allocate values");
+	for(long i = 0; i != N_ITEMS; ++i) values[i] = i;
+
+	sum_t sum = {.sys = sys, .values = values, .count = N_ITEMS};
+	LinceJobCounter counter = {0};
+	LinceRunJob(sys, sum_values, &sum, &counter);
+	LinceWaitForCounter(sys, &counter);
+
+	long expected = (long)N_ITEMS * (N_ITEMS - 1) / 2;
+	free(values);
+	LinceDeleteJobSystem(sys);
+	TEST_ASSERT(sum.result == expected, "Wrong sum from nested jobs");
+	return TEST_PASS;
+}
+
+/* Job that queues another one after a delay, while the system may be deleted */
+typedef struct late_child_t {
+	LinceJobSystem* sys;
+	volatile long started, child_done;
+} late_child_t;
+
+static void run_late_child(void* data){
+	late_child_t* state = data;
+	state->child_done = 1;
+}
+
+static void run_late_parent(void* data){
+	late_child_t* state = data;
+	state->started = 1;
+	double start = LinceGetTimeMillisec();
+	while(LinceGetTimeMillisec() - start < 20.0);
+	LinceRunJob(state->sys, run_late_child, state, NULL);
+}
+
+int test_delete_waits_for_jobs(){
+	late_child_t state = {0};
+	state.sys = LinceCreateJobSystem(4);
+	LinceRunJob(state.sys, run_late_parent, &state, NULL);
+
+	// a worker takes the parent, which is running when the system is deleted
+	while(!state.started);
+	LinceDeleteJobSystem(state.sys);
+	TEST_ASSERT(state.child_done, "Job queued by a running job was not run");
+	return TEST_PASS;
+}
+
+/* Writes twice the index of each item */
+static void double_range(void* data, size_t begin, size_t end){
+	long* items = data;
+	for(size_t i = begin; i != end; ++i) items[i] = (long)i * 2;
+}
+
+int test_parallel_for(){
+	LinceJobSystem* sys = LinceCreateJobSystem(4);
+	long* items = calloc(N_ITEMS, sizeof(long));
+	TEST_ASSERT(items, "Failed to allocate items");
+
+	// automatic, uneven and single-chunk grains
+	size_t grains[] = {0, 7, N_ITEMS};
+	for(int g = 0; g != 3; ++g){
+		memset(items, 0, sizeof(long) * N_ITEMS);
+		LinceParallelFor(sys, N_ITEMS, grains[g], double_range, items);
+		for(long i = 0; i != N_ITEMS; ++i){
+			TEST_ASSERT(items[i] == i * 2, "Item not covered by parallel for");
+		}
+	}
+	free(items);
+	LinceDeleteJobSystem(sys);
+	return TEST_PASS;
+}
+
+/* Arithmetic-heavy work on each item */
+static void compute_range(void* data, size_t begin, size_t end){
+	float* items = data;
+	for(size_t i = begin; i != end; ++i){
+		float x = (float)i;
+		for(int k = 0; k != N_WORK; ++k) x = sqrtf(x * x + 1.0f);
+		items[i] = x;
+	}
+}
+
+/*
+Measures the speedup of a parallel for loop from one thread to one per core.
+Takes the best of a few runs, and only reports the speedup,
+which depends on the load of the machine.
+*/
+int bench_jobs_scaling(){
+	float* items = malloc(sizeof(float) * N_ITEMS);
+	float* expected = malloc(sizeof(float) * N_ITEMS);
+	TEST_ASSERT(items && expected, "Failed to allocate items");
+	compute_range(expected, 0, N_ITEMS);
+
+	uint32_t cores = LinceGetCoreCount();
+	double single_ms = 0.0;
+	for(uint32_t threads = 1; threads <= cores; threads *= 2){
+		// always measure with every core last
+		if(threads * 2 > cores) threads = cores;
+
+		LinceJobSystem* sys = LinceCreateJobSystem(threads);
+		double best_ms = 0.0;
+		for(int run = 0; run != N_BENCH_RUNS; ++run){
+			double start = LinceGetTimeMillisec();
+			LinceParallelFor(sys, N_ITEMS, 0, compute_range, items);
+			double ms = LinceGetTimeMillisec() - start;
+			if(run == 0 || ms < best_ms) best_ms = ms;
+		}
+		LinceDeleteJobSystem(sys);
+
+		if(threads == 1) single_ms = best_ms;
+		printf("%s: %u threads: %.2f ms (speedup %.2f)\n",
+			__FUNCTION__, threads, best_ms, single_ms / best_ms);
+		TEST_ASSERT(memcmp(items, expected, sizeof(float) * N_ITEMS) == 0,
+			"Wrong results from parallel for");
+		if(threads == cores) break;
+	}
+	free(items);
+	free(expected);
+	return TEST_PASS;
+}
+
+
+void jobs_test(){
+	struct test_t tests[] = {
+		{.fn = test_run_jobs,         .name = "test_run_jobs"},
+		{.fn = test_job_dependencies, .name = "test_job_dependencies"},
+		{.fn = test_nested_jobs,      .name = "test_nested_jobs"},
+		{.fn = test_parallel_for,     .name = "test_parallel_for"},
+		{.fn = test_delete_waits_for_jobs, .name = "test_delete_waits_for_jobs"},
+		{.fn = bench_jobs_scaling,    .name = "bench_jobs_scaling"},
+	};
+	uint32_t count = sizeof(tests) / sizeof(struct test_t);
+
+	run_tests(tests, count, "jobs");
+}
@@ -5,6 +5,19 @@
 int main(int argc, const char* argv[]){
 
 	containers_test();
+	transform_test();
+	camera_test();
+	atlas_test();
+	draw_queue_test();
+	jobs_test();
+	cooked_texture_test();
+	block_compression_test();
+	profiler_test();
+	gpu_timer_test();
+	timestep_test();
+	texture_load_test();
+	shader_test();
+	quad_buffer_test();
 
 	return 0;
 }
\ No newline at end of file
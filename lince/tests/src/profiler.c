@@ -0,0 +1,120 @@
+#include "tests.h"
+#include "test.h"
+#include "lince/core/profiler.h"
+#include "lince/core/jobs.h"
+
+#define PROFILER_TEST_FILE "test_profile.json"
+#define N_RANGES 8
+#define N_BENCH_SCOPES 1000000
+#define N_THREAD_RUNS (LINCE_PROFILER_MAX_THREADS * 2)
+
+/* Records an outer scope with an inner one, from any thread */
+static void profile_range(void* data, size_t begin, size_t end){
+	LINCE_UNUSED(data);
+	for(size_t i = begin; i != end; ++i){
+		LinceProfileScope outer = LinceBeginProfileScope();
+		LinceProfileScope inner = LinceBeginProfileScope();
+		LinceEndProfileScope("inner", inner);
+		LinceEndProfileScope("outer", outer);
+	}
+}
+
+int test_profiler_trace(){
+	TEST_ASSERT(!LinceIsProfilerRunning(), "Profiler running before start");
+	LinceProfileScope idle = LinceBeginProfileScope();
+	TEST_ASSERT(idle.start == 0, "Scope opened while profiler stopped");
+
+	TEST_ASSERT(LinceStartProfiler(PROFILER_TEST_FILE), "Failed to start profiler");
+	TEST_ASSERT(!LinceStartProfiler(PROFILER_TEST_FILE), "Profiler started twice");
+	LinceJobSystem* sys = LinceCreateJobSystem(4);
+	LinceParallelFor(sys, N_RANGES, 1, profile_range, NULL);
+	LinceDeleteJobSystem(sys);
+
+	LinceRecordProfileCounter("batches", 3);
+
+	// an unfinished scope does not break the depth of the next ones
+	LinceBeginProfileScope();
+	profile_range(NULL, 0, 1);
+	LinceStopProfiler();
+	TEST_ASSERT(!LinceIsProfilerRunning(), "Profiler running after stop");
+	TEST_ASSERT(LinceGetProfilerDroppedEvents() == 0, "Profiler dropped events");
+
+	TEST_ASSERT(count_in_file(PROFILER_TEST_FILE, "\"traceEvents\":[") == 1, "No trace events");
+	TEST_ASSERT(count_in_file(PROFILER_TEST_FILE, "\"name\":\"outer\"") == N_RANGES + 1,
+		"Wrong number of outer scopes");
+	TEST_ASSERT(count_in_file(PROFILER_TEST_FILE, "\"depth\":1") == N_RANGES + 1,
+		"Wrong depth of inner scopes");
+	TEST_ASSERT(count_in_file(PROFILER_TEST_FILE, "\"depth\":2") == 1,
+		"Wrong depth of scopes within an unfinished one");
+	TEST_ASSERT(count_in_file(PROFILER_TEST_FILE,
+		"\"name\":\"batches\",\"ph\":\"C\"") == 1, "Counter not recorded");
+	TEST_ASSERT(count_in_file(PROFILER_TEST_FILE, "\"args\":{\"value\":3}") == 1,
+		"Wrong counter value");
+	TEST_ASSERT(count_in_file(PROFILER_TEST_FILE, "]}") == 1, "Trace not closed");
+	remove(PROFILER_TEST_FILE);
+	return TEST_PASS;
+}
+
+/* Records one scope on a worker thread */
+static void profile_worker(void* data){
+	LINCE_UNUSED(data);
+	LinceProfileScope scope = LinceBeginProfileScope();
+	LinceEndProfileScope("worker", scope);
+}
+
+/* Threads that exit hand their rings to new ones, so more threads than the limit may record */
+int test_profiler_thread_rings(){
+	TEST_ASSERT(LinceStartProfiler(PROFILER_TEST_FILE), "Failed to start profiler");
+	for(int i = 0; i != N_THREAD_RUNS; ++i){
+		LinceJobSystem* sys = LinceCreateJobSystem(2);
+		LinceJobCounter counter = {0};
+		LinceRunJob(sys, profile_worker, NULL, &counter);
+		// polled instead of waited on, so that the job runs on the worker
+		while(!LinceIsCounterZero(&counter));
+		LinceDeleteJobSystem(sys);
+	}
+	LinceStopProfiler();
+	TEST_ASSERT(LinceGetProfilerDroppedEvents() == 0, "Profiler dropped events");
+	TEST_ASSERT(count_in_file(PROFILER_TEST_FILE, "\"name\":\"worker\"") == N_THREAD_RUNS,
+		"Wrong number of worker scopes");
+	remove(PROFILER_TEST_FILE);
+	return TEST_PASS;
+}
+
+/* Measures the cost of a scope with the profiler stopped and running */
+int bench_profile_scope(){
+	long int n_op = N_BENCH_SCOPES;
+	printf("[stopped] ");
+	TEST_CLOCK_START(time_stopped);
+	for(long i = 0; i != n_op; ++i){
+		LinceProfileScope scope = LinceBeginProfileScope();
+		LinceEndProfileScope("bench", scope);
+	}
+	TEST_CLOCK_END(time_stopped, n_op);
+
+	TEST_ASSERT(LinceStartProfiler(PROFILER_TEST_FILE), "Failed to start profiler");
+	printf("[running] ");
+	TEST_CLOCK_START(time_running);
+	for(long i = 0; i != n_op; ++i){
+		LinceProfileScope scope = LinceBeginProfileScope();
+		LinceEndProfileScope("bench", scope);
+	}
+	TEST_CLOCK_END(time_running, n_op);
+	LinceStopProfiler();
+	printf("%s: %lu events dropped\n", __FUNCTION__,
+		(unsigned long)LinceGetProfilerDroppedEvents());
+	remove(PROFILER_TEST_FILE);
+	return TEST_PASS;
+}
+
+
+void profiler_test(){
+	struct test_t tests[] = {
+		{.fn = test_profiler_trace, .name = "test_profiler_trace"},
+		{.fn = test_profiler_thread_rings, .name = "test_profiler_thread_rings"},
+		{.fn = bench_profile_scope, .name = "bench_profile_scope"},
+	};
+	uint32_t count = sizeof(tests) / sizeof(struct test_t);
+
+	run_tests(tests, count, "profiler");
+}
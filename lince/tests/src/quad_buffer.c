@@ -0,0 +1,116 @@
+#include "tests.h"
+#include "test.h"
+#include "lince/core/window.h"
+#include "lince/core/jobs.h"
+#include "lince/core/memory.h"
+#include "lince/renderer/renderer.h"
+#include "lince/renderer/camera.h"
+#include "lince/renderer/texture.h"
+
+#include <glad/glad.h>
+
+#define N_QUADS 50000    // more than fit in one batch
+#define N_TEXTURES 40    // more than fit in the slots of one batch
+#define N_THREADS 4
+#define QUAD_GRAIN 1000
+
+/* Quads to record, and one buffer per thread of the job system */
+typedef struct QuadRecording {
+	LinceJobSystem* jobs;
+	LinceQuadBuffer** buffers;
+	const LinceQuadProps* quads;
+} QuadRecording;
+
+/* Records a range of quads into the buffer of the calling thread */
+static void record_quads(void* data, size_t begin, size_t end){
+	QuadRecording* rec = data;
+	LinceQuadBuffer* buffer = rec->buffers[LinceGetJobThreadIndex(rec->jobs)];
+	LinceRecordQuads(buffer, rec->quads + begin, end - begin);
+}
+
+/* Fills quads over an area larger than the view, some translucent, spread over the textures */
+static void make_quads(LinceQuadProps* quads, LinceTexture** textures){
+	uint32_t seed = 12345;
+	for(size_t i = 0; i != N_QUADS; ++i){
+		float r[4];
+		for(int j = 0; j != 4; ++j){
+			seed = seed * 1664525u + 1013904223u;
+			r[j] = (float)(seed >> 16) / 65535.0f;
+		}
+		quads[i] = (LinceQuadProps){
+			.x = 6.0f * r[0] - 3.0f,
+			.y = 4.0f * r[1] - 2.0f,
+			.w = 0.05f, .h = 0.05f,
+			.zorder = r[2],
+			.rotation = 90.0f * r[3],
+			.color = {1.0f, 1.0f, 1.0f, (i % 8 == 0) ? 0.5f : 1.0f},
+			.texture = (i % 5 == 0) ? NULL : textures[i % N_TEXTURES],
+		};
+	}
+}
+
+/* Quads recorded in parallel into per-thread buffers draw like those drawn on one thread */
+int test_quad_buffer_parallel(){
+	LinceWindow* window = LinceCreateWindow(64, 64, "quad_buffer", LinceWindow_Headless);
+	TEST_ASSERT(window, "Failed to create headless window");
+	LinceInitRenderer();
+	LinceSetQuadCulling(LinceTrue);
+	LinceCamera* cam = LinceCreateCamera(1.0f);
+
+	LinceTexture* textures[N_TEXTURES];
+	unsigned char pixel[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+	for(int i = 0; i != N_TEXTURES; ++i){
+		char name[LINCE_NAME_MAX];
+		snprintf(name, sizeof(name), "quad_buffer_%d", i);
+		textures[i] = LinceCreateEmptyTexture(name, 1, 1);
+		LinceSetTextureData(textures[i], pixel);
+	}
+	LinceQuadProps* quads = LinceMalloc(sizeof(LinceQuadProps) * N_QUADS);
+	make_quads(quads, textures);
+
+	LinceBeginScene(cam);
+	LinceDrawQuads(quads, N_QUADS);
+	LinceEndScene();
+	LinceEndRendererFrame(0.0f);
+	LinceRendererStats single = LinceGetRendererStats();
+	TEST_ASSERT(single.quads_culled > 0, "No quads culled");
+	TEST_ASSERT(single.batches > 1, "Quads drawn in a single batch");
+
+	LinceJobSystem* jobs = LinceCreateJobSystem(N_THREADS);
+	uint32_t thread_count = LinceGetJobThreadCount(jobs);
+	LinceQuadBuffer* buffers[N_THREADS];
+	for(uint32_t i = 0; i != thread_count; ++i) buffers[i] = LinceCreateQuadBuffer();
+	QuadRecording rec = {.jobs = jobs, .buffers = buffers, .quads = quads};
+
+	LinceBeginScene(cam);
+	LinceParallelFor(jobs, N_QUADS, QUAD_GRAIN, record_quads, &rec);
+	for(uint32_t i = 0; i != thread_count; ++i) LinceSubmitQuadBuffer(buffers[i]);
+	LinceEndScene();
+	LinceEndRendererFrame(0.0f);
+	LinceRendererStats parallel = LinceGetRendererStats();
+
+	TEST_ASSERT(parallel.quads_drawn == single.quads_drawn, "Different number of quads drawn");
+	TEST_ASSERT(parallel.quads_culled == single.quads_culled, "Different number of quads culled");
+	TEST_ASSERT(parallel.batches == single.batches, "Different number of batches");
+	TEST_ASSERT(glGetError() == GL_NO_ERROR, "OpenGL error");
+
+	for(uint32_t i = 0; i != thread_count; ++i) LinceDeleteQuadBuffer(buffers[i]);
+	LinceDeleteJobSystem(jobs);
+	LinceFree(quads);
+	for(int i = 0; i != N_TEXTURES; ++i) LinceDeleteTexture(textures[i]);
+	LinceDeleteCamera(cam);
+	LinceSetQuadCulling(LinceFalse);
+	LinceTerminateRenderer();
+	LinceDestroyWindow(window);
+	return TEST_PASS;
+}
+
+
+void quad_buffer_test(){
+	struct test_t tests[] = {
+		{.fn = test_quad_buffer_parallel, .name = "test_quad_buffer_parallel"},
+	};
+	uint32_t count = sizeof(tests) / sizeof(struct test_t);
+
+	run_tests(tests, count, "quad_buffer");
+}
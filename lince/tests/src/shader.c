@@ -0,0 +1,118 @@
+#include "tests.h"
+#include "test.h"
+#include "lince/core/window.h"
+#include "lince/renderer/shader.h"
+#include "lince/core/profiler.h"
+
+#include <glad/glad.h>
+
+#ifdef LINCE_LINUX
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#define SHADER_CACHE_TEST_DIR "test_shader_cache"
+#define N_SHADER_LOADS 10
+
+static const char* vertex_src =
+	"#version 450 core\n"
+	"layout (location = 0) in vec2 aPos;\n"
+	"void main(){ gl_Position = vec4(aPos, 0.0, 1.0); }\n";
+
+static const char* fragment_src =
+	"#version 450 core\n"
+	"uniform vec4 uColor;\n"
+	"uniform float uScale[2];\n"
+	"out vec4 color;\n"
+	"void main(){ color = uColor * uScale[0] * uScale[1]; }\n";
+
+/* Uniforms found on link, and missing ones after the first lookup, are cached */
+int test_shader_uniform_cache(){
+	LinceWindow* window = LinceCreateWindow(64, 64, "shader", LinceWindow_Headless);
+	TEST_ASSERT(window, "Failed to create headless window");
+	LinceSetShaderCacheDir(NULL);
+	LinceShader* shader = LinceCreateShaderFromSrc("test", vertex_src, fragment_src);
+
+	int color = LinceGetShaderUniformID(shader, "uColor");
+	TEST_ASSERT(color >= 0, "Uniform not found");
+	TEST_ASSERT(color == glGetUniformLocation(shader->id, "uColor"), "Wrong uniform location");
+	TEST_ASSERT(LinceGetShaderUniformID(shader, "uScale") ==
+		LinceGetShaderUniformID(shader, "uScale[0]"), "Array not found by its bare name");
+
+	TEST_ASSERT(!hashmap_has_key(&shader->uniforms, "uMissing"), "Missing uniform cached early");
+	TEST_ASSERT(LinceGetShaderUniformID(shader, "uMissing") == -1, "Missing uniform found");
+	TEST_ASSERT(hashmap_has_key(&shader->uniforms, "uMissing"), "Missing uniform not cached");
+	TEST_ASSERT(LinceGetShaderUniformID(shader, "uMissing") == -1, "Cached miss not decoded");
+
+	LinceDeleteShader(shader);
+	LinceDestroyWindow(window);
+	return TEST_PASS;
+}
+
+#ifdef LINCE_LINUX
+/* Deletes the files of the test cache directory, returns how many start with a prefix */
+static int clear_cache_dir(const char* prefix){
+	DIR* dir = opendir(SHADER_CACHE_TEST_DIR);
+	if(!dir) return 0;
+	int count = 0;
+	char path[512];
+	for(struct dirent* e = readdir(dir); e; e = readdir(dir)){
+		if(e->d_name[0] == '.') continue;
+		if(strncmp(e->d_name, prefix, strlen(prefix)) == 0) ++count;
+		snprintf(path, sizeof(path), "%s/%s", SHADER_CACHE_TEST_DIR, e->d_name);
+		remove(path);
+	}
+	closedir(dir);
+	rmdir(SHADER_CACHE_TEST_DIR);
+	return count;
+}
+
+/*
+Times the creation of a shader with an empty cache (cold), which compiles and links it,
+and with the binary cached by the first run (warm).
+The shader name is sanitized so that the binary stays in the cache directory.
+*/
+int bench_shader_cache(){
+	LinceWindow* window = LinceCreateWindow(64, 64, "shader", LinceWindow_Headless);
+	TEST_ASSERT(window, "Failed to create headless window");
+	clear_cache_dir("");
+	LinceSetShaderCacheDir(SHADER_CACHE_TEST_DIR);
+
+	double cold_ms = 0.0, warm_ms = 0.0;
+	for(int n = 0; n != N_SHADER_LOADS; ++n){
+		clear_cache_dir("");
+		double start = LinceGetTimeMillisec();
+		LinceShader* shader = LinceCreateShaderFromSrc("../cold", vertex_src, fragment_src);
+		glFinish();
+		cold_ms += (LinceGetTimeMillisec() - start) / N_SHADER_LOADS;
+		LinceDeleteShader(shader);
+	}
+	for(int n = 0; n != N_SHADER_LOADS; ++n){
+		double start = LinceGetTimeMillisec();
+		LinceShader* shader = LinceCreateShaderFromSrc("../cold", vertex_src, fragment_src);
+		glFinish();
+		warm_ms += (LinceGetTimeMillisec() - start) / N_SHADER_LOADS;
+		TEST_ASSERT(LinceGetShaderUniformID(shader, "uColor") >= 0, "Cached shader has no uniforms");
+		LinceDeleteShader(shader);
+	}
+	LinceSetShaderCacheDir(NULL);
+	LinceDestroyWindow(window);
+
+	printf("%s: cold %.3f ms, warm %.3f ms\n", __FUNCTION__, cold_ms, warm_ms);
+	TEST_ASSERT(clear_cache_dir("___cold-") == 1, "Shader binary not in the cache directory");
+	return TEST_PASS;
+}
+#endif
+
+
+void shader_test(){
+	struct test_t tests[] = {
+		{.fn = test_shader_uniform_cache, .name = "test_shader_uniform_cache"},
+#ifdef LINCE_LINUX
+		{.fn = bench_shader_cache,        .name = "bench_shader_cache"},
+#endif
+	};
+	uint32_t count = sizeof(tests) / sizeof(struct test_t);
+
+	run_tests(tests, count, "shader");
+}
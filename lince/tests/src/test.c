@@ -10,4 +10,20 @@ void run_tests(struct test_t* tests, uint32_t count, const char* batch_name){
 		else printf("["RED"FAILED"NOCOLOR"]");
 		printf(" %s\n", t->name);
 	}
+}
+
+int count_in_file(const char* path, const char* str){
+	FILE* file = fopen(path, "rb");
+	if(!file) return -1;
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	char* text = calloc((size_t)size + 1, 1);
+	int count = 0;
+	if(text && fread(text, (size_t)size, 1, file) == 1){
+		for(char* c = text; (c = strstr(c, str)); c += strlen(str)) ++count;
+	}
+	free(text);
+	fclose(file);
+	return count;
 }
\ No newline at end of file
@@ -27,6 +27,9 @@ struct test_t {
 
 void run_tests(struct test_t* tests, uint32_t count, const char* batch_name);
 
+/* Counts the occurrences of a string in a file, or returns -1 if it cannot be read */
+int count_in_file(const char* path, const char* str);
+
 /* ANSI colour codes */
 #define GREEN "\e[1;32m"
 #define RED "\e[1;31m"
@@ -1,2 +1,15 @@
 
-void containers_test();
\ No newline at end of file
+void containers_test();
+void transform_test();
+void camera_test();
+void atlas_test();
+void draw_queue_test();
+void jobs_test();
+void cooked_texture_test();
+void block_compression_test();
+void profiler_test();
+void gpu_timer_test();
+void timestep_test();
+void texture_load_test();
+void shader_test();
+void quad_buffer_test();
\ No newline at end of file
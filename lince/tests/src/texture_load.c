@@ -0,0 +1,129 @@
+#include "tests.h"
+#include "test.h"
+#include "lince/core/window.h"
+#include "lince/core/jobs.h"
+#include "lince/renderer/texture.h"
+#include "lince/core/profiler.h"
+
+#include <glad/glad.h>
+#include <stb_image.h>
+
+#define TEXTURE_LOAD_PATH LINCE_DIR"editor/assets/textures/elv-games-movement.png"
+#define TEXTURE_SPIKE_PATH LINCE_DIR"deps/cglm/cglm.png"
+#define LOAD_TIMEOUT_MS 10000.0
+
+/* Queues a load, pumps it a few rows per frame, and reads the texture back */
+int test_texture_load_async(){
+	LinceWindow* window = LinceCreateWindow(64, 64, "texture_load", LinceWindow_Headless);
+	TEST_ASSERT(window, "Failed to create headless window");
+	LinceJobSystem* jobs = LinceCreateJobSystem(2);
+
+	LinceTextureLoad* load = LinceLoadTextureAsync(jobs, "async", TEXTURE_LOAD_PATH,
+		LinceTexture_FlipY);
+	TEST_ASSERT(load, "Failed to queue texture load");
+	TEST_ASSERT(!LinceIsTextureReady(load), "Texture ready before any update");
+
+	// budget of a few rows, so that the upload takes several frames
+	int frames = 0;
+	double start = LinceGetTimeMillisec();
+	while(!LinceIsTextureReady(load) && load->state != LinceTextureLoad_Failed){
+		TEST_ASSERT(LinceGetTimeMillisec() - start < LOAD_TIMEOUT_MS, "Texture load never finished");
+		LinceUpdateTextureLoads(1024);
+		++frames;
+	}
+	TEST_ASSERT(LinceIsTextureReady(load), "Texture load failed");
+	TEST_ASSERT(frames > 2, "Texture uploaded in a single frame");
+
+	int width = 0, height = 0, channels = 0;
+	stbi_set_flip_vertically_on_load(1);
+	unsigned char* image = stbi_load(TEXTURE_LOAD_PATH, &width, &height, &channels, 4);
+	stbi_set_flip_vertically_on_load(0);
+	TEST_ASSERT(image, "Failed to decode image");
+
+	LinceTexture* texture = LinceGetLoadedTexture(load);
+	TEST_ASSERT(texture->width == (uint32_t)width && texture->height == (uint32_t)height,
+		"Wrong texture size");
+	size_t size = (size_t)width * height * 4;
+	unsigned char* pixels = malloc(size);
+	glGetTextureImage(texture->id, 0, GL_RGBA, GL_UNSIGNED_BYTE, (GLsizei)size, pixels);
+	TEST_ASSERT(glGetError() == GL_NO_ERROR, "OpenGL error");
+	TEST_ASSERT(memcmp(pixels, image, size) == 0, "Texture differs from image");
+
+	free(pixels);
+	stbi_image_free(image);
+	LinceDeleteTextureLoad(load);
+	LinceDeleteTexture(texture);
+	LinceDeleteJobSystem(jobs);
+	LinceDestroyWindow(window);
+	return TEST_PASS;
+}
+
+/* A missing file fails the load instead of leaving it pending */
+int test_texture_load_missing(){
+	LinceWindow* window = LinceCreateWindow(64, 64, "texture_load", LinceWindow_Headless);
+	TEST_ASSERT(window, "Failed to create headless window");
+
+	LinceTextureLoad* load = LinceLoadTextureAsync(NULL, "missing", "missing.png", 0);
+	LinceUpdateTextureLoads(LINCE_TEXTURE_UPLOAD_BUDGET);
+	TEST_ASSERT(load->state == LinceTextureLoad_Failed, "Missing texture not failed");
+	TEST_ASSERT(!LinceIsTextureReady(load), "Missing texture ready");
+
+	LinceDeleteTextureLoad(load);
+	LinceDestroyWindow(window);
+	return TEST_PASS;
+}
+
+/* Compares the longest frame of a blocking load against a background one */
+int bench_texture_load_spike(){
+	LinceWindow* window = LinceCreateWindow(64, 64, "texture_load", LinceWindow_Headless);
+	TEST_ASSERT(window, "Failed to create headless window");
+	LinceJobSystem* jobs = LinceCreateJobSystem(2);
+
+	// the whole load happens within one frame
+	double start = LinceGetTimeMillisec();
+	LinceTexture* texture = LinceLoadTexture("sync", TEXTURE_SPIKE_PATH, 0);
+	glFinish();
+	double sync_ms = LinceGetTimeMillisec() - start;
+	TEST_ASSERT(texture, "Failed to load texture");
+	LinceDeleteTexture(texture);
+
+	double async_ms = 0.0, total_ms = 0.0;
+	int frames = 0;
+	start = LinceGetTimeMillisec();
+	LinceTextureLoad* load = LinceLoadTextureAsync(jobs, "async", TEXTURE_SPIKE_PATH, 0);
+	glFinish();
+	async_ms = LinceGetTimeMillisec() - start;
+	while(!LinceIsTextureReady(load) && load->state != LinceTextureLoad_Failed){
+		TEST_ASSERT(LinceGetTimeMillisec() - start < LOAD_TIMEOUT_MS, "Texture load never finished");
+		++frames;
+		double frame_start = LinceGetTimeMillisec();
+		LinceUpdateTextureLoads(LINCE_TEXTURE_UPLOAD_BUDGET);
+		glFinish();
+		double frame_ms = LinceGetTimeMillisec() - frame_start;
+		if(frame_ms > async_ms) async_ms = frame_ms;
+	}
+	total_ms = LinceGetTimeMillisec() - start;
+	TEST_ASSERT(LinceIsTextureReady(load), "Texture load failed");
+
+	printf("%s: longest frame %.2f ms blocking, %.2f ms in background"
+		" (%d frames, %.2f ms in total)\n",
+		__FUNCTION__, sync_ms, async_ms, frames, total_ms);
+
+	LinceDeleteTexture(LinceGetLoadedTexture(load));
+	LinceDeleteTextureLoad(load);
+	LinceDeleteJobSystem(jobs);
+	LinceDestroyWindow(window);
+	return TEST_PASS;
+}
+
+
+void texture_load_test(){
+	struct test_t tests[] = {
+		{.fn = test_texture_load_async,   .name = "test_texture_load_async"},
+		{.fn = test_texture_load_missing, .name = "test_texture_load_missing"},
+		{.fn = bench_texture_load_spike,  .name = "bench_texture_load_spike"},
+	};
+	uint32_t count = sizeof(tests) / sizeof(struct test_t);
+
+	run_tests(tests, count, "texture_load");
+}
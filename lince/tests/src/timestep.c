@@ -0,0 +1,54 @@
+#include "tests.h"
+#include "test.h"
+#include "lince/core/timestep.h"
+#include <math.h>
+
+#define EPS 1e-3f
+
+int test_timestep_steps(){
+	LinceFixedTimestep ts = {.step = 10.0f};
+
+	// frames shorter than a step accumulate until one is due
+	TEST_ASSERT(LinceAdvanceFixedTimestep(&ts, 4.0f) == 0, "Step run before it was due");
+	TEST_ASSERT(fabsf(ts.alpha - 0.4f) < EPS, "Wrong alpha");
+	TEST_ASSERT(LinceAdvanceFixedTimestep(&ts, 7.0f) == 1, "Due step was not run");
+	TEST_ASSERT(fabsf(ts.accumulator - 1.0f) < EPS, "Leftover time was lost");
+
+	// long frames run several steps
+	TEST_ASSERT(LinceAdvanceFixedTimestep(&ts, 29.5f) == 3, "Wrong number of steps");
+	TEST_ASSERT(fabsf(ts.alpha - 0.05f) < EPS, "Wrong alpha");
+	TEST_ASSERT(ts.steps == 4, "Wrong step count");
+
+	// disabled
+	ts.step = 0.0f;
+	TEST_ASSERT(LinceAdvanceFixedTimestep(&ts, 100.0f) == 0, "Steps run while disabled");
+	TEST_ASSERT(ts.alpha == 0.0f, "Alpha set while disabled");
+	return TEST_PASS;
+}
+
+int test_timestep_max_steps(){
+	LinceFixedTimestep ts = {.step = 10.0f, .max_steps = 3};
+
+	// a hitch runs at most `max_steps` and drops whole steps, keeping the phase
+	TEST_ASSERT(LinceAdvanceFixedTimestep(&ts, 1005.0f) == 3, "Steps not capped");
+	TEST_ASSERT(fabsf(ts.alpha - 0.5f) < EPS, "Phase lost after hitch");
+	TEST_ASSERT(fabs(ts.dropped_ms - 970.0) < EPS, "Wrong dropped time");
+	TEST_ASSERT(LinceAdvanceFixedTimestep(&ts, 10.0f) == 1, "Simulation still behind after hitch");
+
+	// default cap
+	ts.max_steps = 0;
+	TEST_ASSERT(LinceAdvanceFixedTimestep(&ts, 1.0e12f) == LINCE_FIXED_UPDATE_MAX_STEPS,
+		"Default cap not applied");
+	return TEST_PASS;
+}
+
+
+void timestep_test(){
+	struct test_t tests[] = {
+		{.fn = test_timestep_steps,     .name = "test_timestep_steps"},
+		{.fn = test_timestep_max_steps, .name = "test_timestep_max_steps"},
+	};
+	uint32_t count = sizeof(tests) / sizeof(struct test_t);
+
+	run_tests(tests, count, "timestep");
+}
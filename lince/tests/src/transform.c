@@ -0,0 +1,135 @@
+#include "tests.h"
+#include "test.h"
+#include "lince/renderer/transform.h"
+#include "cglm/affine.h"
+#include <math.h>
+
+#define N_QUADS 2000000
+
+/* Vertex with the same layout as the renderer's */
+typedef struct vertex_t {
+	float x, y, z;
+	float s, t;
+	uint8_t color[4];
+	uint16_t texture_id;
+	uint16_t padding;
+} vertex_t;
+
+static const float quad_x[4] = {-0.5f,  0.5f, 0.5f, -0.5f};
+static const float quad_y[4] = {-0.5f, -0.5f, 0.5f,  0.5f};
+static const float quad_st[8] = {0,0, 1,0, 1,1, 0,1};
+static const uint8_t white[4] = {255, 255, 255, 255};
+
+/* Previous kernel: builds a 4x4 matrix and transforms each vertex */
+static void transform_quad_mat4(
+	vertex_t* v, float x, float y, float z, float w, float h, float rot
+){
+	mat4 transform = GLM_MAT4_IDENTITY_INIT;
+	vec4 pos = {x, y, z, 1.0};
+	vec3 scale = {w, h, 1.0};
+	glm_translate(transform, pos);
+	glm_rotate(transform, glm_rad(rot), (vec3){0.0, 0.0, -1.0});
+	glm_scale(transform, scale);
+
+	for(int i = 0; i != 4; ++i){
+		vertex_t vertex = {0};
+		vec4 vpos = {quad_x[i], quad_y[i], 0.0, 1.0};
+		vec4 res;
+		glm_mat4_mulv(transform, vpos, res);
+		vertex.x = res[0];
+		vertex.y = res[1];
+		vertex.z = res[2];
+		vertex.s = quad_st[i*2];
+		vertex.t = quad_st[i*2+1];
+		memcpy(vertex.color, white, sizeof(white));
+		memcpy(v + i, &vertex, sizeof(vertex));
+	}
+}
+
+/* Current kernel: 2D affine transform written straight into the vertices */
+static void transform_quad_affine(
+	vertex_t* v, float x, float y, float z, float w, float h, float rot
+){
+	float xs[4], ys[4];
+	LinceTransformQuad(x, y, w, h, rot, xs, ys);
+	for(int i = 0; i != 4; ++i, ++v){
+		v->x = xs[i];
+		v->y = ys[i];
+		v->z = z;
+		v->s = quad_st[i*2];
+		v->t = quad_st[i*2+1];
+		memcpy(v->color, white, sizeof(white));
+		v->texture_id = 0;
+		v->padding = 0;
+	}
+}
+
+static float randf(float min, float max){
+	return min + (max - min) * (float)rand() / (float)RAND_MAX;
+}
+
+int test_transform_quad(){
+	vertex_t a[4], b[4];
+	srand(42);
+	for(int n = 0; n != 10000; ++n){
+		float x = randf(-100,100), y = randf(-100,100), z = randf(0,1);
+		float w = randf(0,10), h = randf(0,10);
+		float rot = (n % 2) ? randf(-720,720) : 0.0f;
+		transform_quad_mat4(a, x, y, z, w, h, rot);
+		transform_quad_affine(b, x, y, z, w, h, rot);
+		for(int i = 0; i != 4; ++i){
+			TEST_ASSERT(fabsf(a[i].x - b[i].x) < 1e-3f && fabsf(a[i].y - b[i].y) < 1e-3f,
+				"Quad corners differ from matrix transform");
+			TEST_ASSERT(a[i].z == b[i].z && a[i].s == b[i].s && a[i].t == b[i].t,
+				"Quad vertex attributes differ from matrix transform");
+		}
+	}
+	return TEST_PASS;
+}
+
+/* Measures quads per millisecond of both kernels, with and without rotation */
+static int bench_transform_quad(float rot){
+	vertex_t* batch = malloc(sizeof(vertex_t) * 4 * 20000);
+	TEST_ASSERT(batch, "Failed to allocate vertex batch");
+	long int n_op = N_QUADS;
+	float sum = 0;
+
+	TEST_CLOCK_START(time_mat4);
+	for(long int n = 0; n != n_op; ++n){
+		transform_quad_mat4(batch + (n % 20000) * 4, (float)(n % 100), 1, 0, 1, 1, rot);
+	}
+	printf("[mat4]   ");
+	TEST_CLOCK_END(time_mat4, n_op);
+	sum += batch[0].x;
+
+	TEST_CLOCK_START(time_affine);
+	for(long int n = 0; n != n_op; ++n){
+		transform_quad_affine(batch + (n % 20000) * 4, (float)(n % 100), 1, 0, 1, 1, rot);
+	}
+	printf("[affine] ");
+	TEST_CLOCK_END(time_affine, n_op);
+	sum += batch[0].x;
+
+	free(batch);
+	return sum == sum ? TEST_PASS : TEST_FAIL; // keeps results alive
+}
+
+int bench_transform_quad_rotated(){
+	return bench_transform_quad(30.0f);
+}
+
+int bench_transform_quad_unrotated(){
+	return bench_transform_quad(0.0f);
+}
+
+
+void transform_test(){
+	struct test_t tests[] = {
+		{.fn = test_transform_quad,            .name = "test_transform_quad"},
+		{.fn = bench_transform_quad_rotated,   .name = "bench_transform_quad_rotated"},
+		{.fn = bench_transform_quad_unrotated, .name = "bench_transform_quad_unrotated"},
+	};
+	uint32_t count = sizeof(tests) / sizeof(struct test_t);
+
+	run_tests(tests, count, "transform");
+}
@@ -6,6 +6,7 @@
 
 typedef struct Collider {
 	float x, y, vx, vy, w, h, angle;
+	float px, py; // position before the last fixed update
 } Collider;
 
 // Check if two non-rotated rectangles overlap
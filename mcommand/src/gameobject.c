@@ -8,10 +8,30 @@ void DrawEntity(GameObject* entity){
 }
 
 void DrawEntityList(array_t* objects){
+	// sprites are gathered and submitted to the renderer in chunks
+	Sprite sprites[64];
+	size_t count = 0;
 	GameObject* item;
 	for(uint32_t i = 0; i != objects->size; ++i){
 		item = array_get(objects, i);
-		DrawEntity(item);
+		if(!item->sprite) continue;
+		sprites[count++] = *item->sprite;
+		if(count == sizeof(sprites)/sizeof(Sprite)){
+			LinceDrawQuads(sprites, count);
+			count = 0;
+		}
+	}
+	if(count) LinceDrawQuads(sprites, count);
+}
+
+void InterpolateEntityList(array_t* objects, float alpha){
+	GameObject* item;
+	for(uint32_t i = 0; i != objects->size; ++i){
+		item = array_get(objects, i);
+		if(!item->sprite || !item->collider) continue;
+		Collider* c = item->collider;
+		item->sprite->x = c->px + (c->x - c->px) * alpha;
+		item->sprite->y = c->py + (c->y - c->py) * alpha;
 	}
 }
 
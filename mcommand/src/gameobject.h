@@ -19,6 +19,10 @@ void DrawEntity(GameObject* entity);
 
 void DrawEntityList(array_t* objects);
 
+// Places sprites between the previous and current positions of their colliders,
+// `alpha` being the fraction of a fixed update elapsed since the last one
+void InterpolateEntityList(array_t* objects, float alpha);
+
 void DeleteEntity(GameObject* entity);
 
 void DeleteEntityItem(array_t* items, uint32_t index);
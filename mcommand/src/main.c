@@ -26,6 +26,7 @@ int main(int argc, const char* argv[]) {
     app->screen_width = 900;
     app->screen_height = 600;
     app->title = "Sandbox";
+    app->fixed_timestep = 1000.0f / 60.0f; // game runs at 60 updates per second
 
     app->game_init = GameInit;
     app->game_on_update = GameOnUpdate;
@@ -33,7 +33,7 @@ Notes:
 #define BOMB_WIDTH 0.1f
 #define BOMB_HEIGHT 0.1f
 #define BOMB_COOLDOWN 3000.0f // bomb drops every 3 sec
-#define BOMB_SPEED 2e-3
+#define BOMB_SPEED 2e-3 // per fixed update
 
 #define BKG_WIDTH 3.5f
 #define BKG_HEIGHT 2.0f
@@ -104,6 +104,8 @@ void CreateBomb(array_t* bomb_list, LinceTexture* texture){
 		.w = BOMB_WIDTH,
 		.h = BOMB_HEIGHT
 	};
+	collider.px = collider.x;
+	collider.py = collider.y;
 	Sprite sprite = {
 		.x = collider.x,
 		.y = collider.y,
@@ -160,18 +162,16 @@ void DeleteInterceptedBombs(array_t* bomb_list, vec2 pos){
 void UpdateBombs(GameState* state){
 
 	Collider *b;
-	Sprite *s;
 	GameObject *obj;
 
-	// Updated collider and sprite locations
+	// Update collider locations, sprites are placed when drawn
 	for(uint32_t i=0; i!=state->bomb_list.size; ++i){
 		obj = array_get(&state->bomb_list, i);
 		b = obj->collider;
-		s = obj->sprite;
+		b->px = b->x;
+		b->py = b->y;
 		b->x += b->vx;
 		b->y += b->vy;
-		s->x = b->x;
-		s->y = b->y;
 	}
 
 	DeleteCrashedBomb(state);
@@ -192,6 +192,8 @@ void CreateMissile(GameState* state, float angle, LinceTexture* texture){
 		.vy = vtot * sinf((90.0f - angle) * (float)M_PI / 180.0f),
 		.angle = angle
 	};
+	collider.px = collider.x;
+	collider.py = collider.y;
 	Sprite sprite = {
 		.x = collider.x,
 		.y = collider.y,
@@ -283,10 +285,10 @@ void UpdateMissiles(GameState* state){
 	for(uint32_t i = 0; i != state->missile_list.size; ++i){
 		ms_obj = array_get(&state->missile_list, i);
 		ms = ms_obj->collider;
+		ms->px = ms->x;
+		ms->py = ms->y;
 		ms->x += ms->vx;
 		ms->y += ms->vy;
-		ms_obj->sprite->x = ms->x;
-		ms_obj->sprite->y = ms->y;
 	}
 
 	DeleteStrayMissiles(state);
@@ -378,21 +380,14 @@ void MCommandOnUpdate(LinceLayer* layer, float dt){
 	LinceResizeCameraView(data->cam, LinceGetAspectRatio());
 	LinceUpdateCamera(data->cam);
 
-	// missile cooldown will be reset when next is launched
-	UpdateTimer(&data->missile_timer, dt);
-	UpdateTimer(&data->bomb_timer, dt);
-	if(data->bomb_timer.finished){
-		ResetTimer(&data->bomb_timer);
-		CreateBomb(&data->bomb_list, data->bomb_tex);
-	}
 	data->angle = CalculateCannonAngle(data->cam);
-	
-	UpdateMissiles(data);
-	UpdateBombs(data);
-	UpdateBlasts(&data->blast_list, dt);
-	
 	DrawDebugUI(data);
 
+	// moving objects are drawn between their last two fixed updates
+	float alpha = LinceGetFixedUpdateAlpha();
+	InterpolateEntityList(&data->missile_list, alpha);
+	InterpolateEntityList(&data->bomb_list, alpha);
+
 	// draw objects
 	LinceBeginScene(data->cam);
 
@@ -426,6 +421,22 @@ void MCommandOnUpdate(LinceLayer* layer, float dt){
 	LinceSetClearColor(0.0, 0.0, 0.0, 1.0);
 }
 
+void MCommandOnFixedUpdate(LinceLayer* layer, float dt){
+	GameState* data = LinceGetLayerData(layer);
+
+	// missile cooldown will be reset when next is launched
+	UpdateTimer(&data->missile_timer, dt);
+	UpdateTimer(&data->bomb_timer, dt);
+	if(data->bomb_timer.finished){
+		ResetTimer(&data->bomb_timer);
+		CreateBomb(&data->bomb_list, data->bomb_tex);
+	}
+
+	UpdateMissiles(data);
+	UpdateBombs(data);
+	UpdateBlasts(&data->blast_list, dt);
+}
+
 void MCommandLayerOnEvent(LinceLayer* layer, LinceEvent* event){
 	if(event->type != LinceEventType_MouseButtonPressed) return;
 	GameState* state = LinceGetLayerData(layer);
@@ -462,6 +473,7 @@ LinceLayer* MCommandLayerInit(){
 
 	layer->OnAttach = MCommandOnAttach;
 	layer->OnUpdate = MCommandOnUpdate;
+	layer->OnFixedUpdate = MCommandOnFixedUpdate;
 	layer->OnEvent  = MCommandLayerOnEvent;
 	layer->OnDetach = MCommandOnDetach;
 	layer->data = calloc(1, sizeof(GameState));
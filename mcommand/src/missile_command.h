@@ -5,6 +5,7 @@
 
 void MCommandOnAttach(LinceLayer* layer);
 void MCommandOnUpdate(LinceLayer* layer, float dt);
+void MCommandOnFixedUpdate(LinceLayer* layer, float dt);
 void MCommandOnDetach(LinceLayer* layer);
 LinceLayer* MCommandLayerInit();
 
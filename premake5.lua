@@ -12,12 +12,13 @@ workspace "lince"
     configurations {"Debug", "Release"}
     filter "system:windows"
         systemversion "latest"
-        defines {"_CRT_SECURE_NO_WARNINGS"}
+        defines {"_CRT_SECURE_NO_WARNINGS", "LINCE_WINDOWS"}
         links {"opengl32"}
 
     filter "system:linux"
         systemversion "latest"    
-        links {"GL","rt","m","dl","pthread","X11"}
+        defines {"LINCE_LINUX"}
+        links {"GL","EGL","rt","m","dl","pthread","X11"}
         
     filter "configurations:Debug"
         symbols "on"
@@ -304,17 +305,56 @@ project "tests"
     objdir ("obj/" .. OutputDir .. "/%{prj.name}")
 
     files {
-        "%{prj.name}/src/**.c",
-        "%{prj.name}/src/**.h",
+        "lince/%{prj.name}/src/**.c",
+        "lince/%{prj.name}/src/**.h",
     }
     
     includedirs {
-        "%{prj.name}",
-        "%{prj.name}/src",
+        "lince/%{prj.name}",
+        "lince/%{prj.name}/src",
+        "%{IncludeDir.lince}",
+        "%{IncludeDir.glfw}",
+        "%{IncludeDir.glad}",
+        "%{IncludeDir.cglm}",
+        "%{IncludeDir.stb}"
+    }
+
+    links {
+        "lince",
+        "glad",
+        "glfw",
+        "cglm",
+        "nuklear",
+        "stb",
+        "miniaudio"
+    }
+
+    libdirs {"bin/" .. OutputDir .. "/lince"}
+
+
+project "lince-bench"
+    kind "ConsoleApp"
+    language "C"
+    staticruntime "on"
+    location "lince/build/lince-bench"
+
+    targetdir ("bin/" .. OutputDir .. "/%{prj.name}")
+    objdir ("obj/" .. OutputDir .. "/%{prj.name}")
+
+    files {
+        "lince/bench/src/**.c",
+        "lince/bench/src/**.h",
+    }
+    
+    includedirs {
+        "lince/bench/src",
         "%{IncludeDir.lince}",
         "%{IncludeDir.glfw}",
         "%{IncludeDir.glad}",
-        "%{IncludeDir.cglm}"
+        "%{IncludeDir.cglm}",
+        "%{IncludeDir.nuklear}",
+        "%{IncludeDir.stb}",
+        "%{IncludeDir.miniaudio}"
     }
 
     links {
@@ -323,7 +363,8 @@ project "tests"
         "glfw",
         "cglm",
         "nuklear",
-        "stb"
+        "stb",
+        "miniaudio"
     }
 
     libdirs {"bin/" .. OutputDir .. "/lince"}